@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Dejavu.h"
+#include <vector>
+
+namespace jlimdev
+{
+    constexpr Timestamp benchmarkNow = 1600000000U;
+    constexpr Timestamp benchmarkDay = 24 * 60 * 60;
+
+    // -- a deck of deckSize cards where duePercent of every hundred are due now, the rest scheduled well into the future...
+    inline std::vector<DeckRecord> BenchmarkDeck(uint deckSize, uint duePercent)
+    {
+        std::vector<DeckRecord> deck;
+        deck.reserve(deckSize);
+
+        for (uint i = 0; i < deckSize; i++)
+        {
+            if (i % 100 < duePercent)
+            {
+                deck.push_back(DeckRecord{ CardState::PreviouslyCorrect, DifficultyRatingMostDifficult, 0,
+                    benchmarkNow - 10 * benchmarkDay - 1, benchmarkNow - 12 * benchmarkDay });
+            }
+            else
+            {
+                deck.push_back(DeckRecord{ CardState::PreviouslyCorrect, DifficultyRatingEasiest, 0,
+                    benchmarkNow - 2 * benchmarkDay, benchmarkNow - 12 * benchmarkDay });
+            }
+        }
+
+        return deck;
+    }
+}
@@ -0,0 +1,117 @@
+// -- moving whole decks in and out: bulk import and export, and snapshots...
+
+#include "BenchmarkDecks.h"
+#include <benchmark/benchmark.h>
+
+using namespace jlimdev;
+
+static void BM_ImportRecords(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 50);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        session.Reset();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(session.ImportRecords(deck.data(), deckSize));
+    }
+
+    state.SetItemsProcessed(state.iterations() * deckSize);
+}
+
+BENCHMARK(BM_ImportRecords)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_ExportRecords(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 50);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+    session.ImportRecords(deck.data(), deckSize);
+
+    std::vector<ExportedRecord> out(deckSize);
+
+    for (auto _ : state)
+    {
+        session.ExportRecords(benchmarkNow, out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * deckSize);
+}
+
+BENCHMARK(BM_ExportRecords)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_SaveSnapshot(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 50);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+    session.ImportRecords(deck.data(), deckSize);
+
+    std::vector<uint8_t> snapshot;
+
+    for (auto _ : state)
+    {
+        session.SaveSnapshot(snapshot);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * snapshot.size());
+}
+
+BENCHMARK(BM_SaveSnapshot)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_LoadSnapshot(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 50);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+    session.ImportRecords(deck.data(), deckSize);
+
+    std::vector<uint8_t> snapshot;
+    session.SaveSnapshot(snapshot);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(session.LoadSnapshot(snapshot.data(), snapshot.size()));
+    }
+
+    state.SetBytesProcessed(state.iterations() * snapshot.size());
+}
+
+BENCHMARK(BM_LoadSnapshot)->RangeMultiplier(10)->Range(1000, 100000);
+
+// -- same image read in place, the way a server opens a MappedSnapshot...
+static void BM_BorrowSnapshot(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 50);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+    session.ImportRecords(deck.data(), deckSize);
+
+    std::vector<uint8_t> snapshot;
+    session.SaveSnapshot(snapshot);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(session.BorrowSnapshot(snapshot.data(), snapshot.size()));
+    }
+
+    state.SetBytesProcessed(state.iterations() * snapshot.size());
+}
+
+BENCHMARK(BM_BorrowSnapshot)->RangeMultiplier(10)->Range(1000, 100000);
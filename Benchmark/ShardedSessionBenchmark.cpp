@@ -0,0 +1,61 @@
+// -- answers per second through the sharded session manager as worker threads are added...
+
+#include "BenchmarkDecks.h"
+#include <benchmark/benchmark.h>
+#include <thread>
+
+using namespace jlimdev;
+
+constexpr uint learnersPerThread = 64;
+constexpr uint shardedDeckSize = 200;
+
+static void LoadNewDeck(SuperMemo2StudySession& session)
+{
+    for (uint i = 0; i < shardedDeckSize; i++)
+    {
+        session.AddNeverReviewed();
+    }
+}
+
+// -- one manager shared by every thread of every run, each thread studying learners of its own...
+static SuperMemo2ShardedSessionManager& SharedManager()
+{
+    static SuperMemo2ReviewStrategy strategy;
+    static SuperMemo2ShardedSessionManager manager(strategy, shardedDeckSize, shardedDeckSize, shardedDeckSize, SIZE_MAX,
+        std::max(std::thread::hardware_concurrency(), 1U) * 16,
+        [](const SessionKey&, SuperMemo2StudySession& session) { LoadNewDeck(session); return true; },
+        nullptr);
+
+    return manager;
+}
+
+static void BM_ShardedAnswers(benchmark::State& state)
+{
+    SuperMemo2ShardedSessionManager& manager = SharedManager();
+    const uint firstLearner = static_cast<uint>(state.thread_index()) * learnersPerThread;
+    uint n = 0;
+
+    for (auto _ : state)
+    {
+        const SessionKey key{ firstLearner + n++ % learnersPerThread, 1 };
+
+        manager.WithSession(key, [](SuperMemo2StudySession& session)
+        {
+            std::optional<uint> i = session.NextReview(benchmarkNow);
+
+            // -- start the deck over once it has been studied through...
+            if (!i)
+            {
+                session.Reset();
+                LoadNewDeck(session);
+                i = session.NextReview(benchmarkNow);
+            }
+
+            session.UpdateCard(*i, ReviewOutcome::Hesitant, benchmarkNow);
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ShardedAnswers)->ThreadRange(1, 16)->UseRealTime();
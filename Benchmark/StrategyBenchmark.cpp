@@ -0,0 +1,130 @@
+// -- SuperMemo2ReviewStrategy on its own: one card at a time, and whole columns through the vector kernel...
+
+#include "BenchmarkDecks.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace jlimdev;
+
+// -- an even mix of the four card states with random ratings and intervals...
+static std::vector<ReviewItem> MixedItems(uint count)
+{
+    std::mt19937 random(18);
+    std::vector<ReviewItem> items;
+    items.reserve(count);
+
+    for (uint i = 0; i < count; i++)
+    {
+        const DifficultyRating rating = random() % (DifficultyRatingMostDifficult + 1);
+        const Timestamp reviewDate = benchmarkNow - static_cast<Timestamp>(random() % (30 * benchmarkDay));
+        const Timestamp interval = static_cast<Timestamp>(1 + random() % 60) * benchmarkDay;
+
+        switch (i % 4)
+        {
+        case 0:
+            items.push_back(NeverReviewed{ rating });
+            break;
+        case 1:
+            items.push_back(PreviouslyIncorrect{ rating, reviewDate });
+            break;
+        case 2:
+            items.push_back(PreviouslyFirstCorrect{ rating, reviewDate });
+            break;
+        default:
+            items.push_back(PreviouslyCorrect{ rating, reviewDate, reviewDate - interval });
+            break;
+        }
+    }
+
+    return items;
+}
+
+static void BM_SuperMemo2NextReview(benchmark::State& state)
+{
+    const SuperMemo2ReviewStrategy strategy;
+    const std::vector<ReviewItem> items = MixedItems(1024);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(strategy.NextReview(items[i], benchmarkNow));
+        i = (i + 1) & 1023;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SuperMemo2NextReview);
+
+static void BM_SuperMemo2AdjustDifficulty(benchmark::State& state)
+{
+    const SuperMemo2ReviewStrategy strategy;
+    const std::vector<ReviewItem> items = MixedItems(1024);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(strategy.AdjustDifficulty(items[i], static_cast<ReviewOutcome>(i % 3)));
+        i = (i + 1) & 1023;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SuperMemo2AdjustDifficulty);
+
+// -- a whole deck scheduled in one call, the way import and strategy swaps do it...
+static void BM_SuperMemo2NextReviewColumns(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const SuperMemo2ReviewStrategy strategy;
+    const std::vector<ReviewItem> items = MixedItems(deckSize);
+
+    CardStore cards;
+
+    for (const ReviewItem& item : items)
+    {
+        cards.Add(item);
+    }
+
+    std::vector<DeckTime> out(deckSize);
+
+    for (auto _ : state)
+    {
+        strategy.NextReviewColumns(cards, 0, deckSize, DueImmediately, out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * deckSize);
+}
+
+BENCHMARK(BM_SuperMemo2NextReviewColumns)->RangeMultiplier(10)->Range(1000, 100000);
+
+// -- scoring one candidate during a fit: replaying every history, then the loss over the scored answers...
+static void BM_SuperMemo2Loss(benchmark::State& state)
+{
+    const uint cards = static_cast<uint>(state.range(0));
+    std::mt19937 random(3);
+    ReviewHistories histories;
+
+    for (uint card = 0; card < cards; card++)
+    {
+        histories.AddAnswer(ReviewOutcome::Perfect, 0);
+
+        for (uint j = 0; j < 4; j++)
+        {
+            histories.AddAnswer((random() % 3 != 0) ? ReviewOutcome::Perfect : ReviewOutcome::Incorrect, random() % (200 * benchmarkDay));
+        }
+
+        histories.EndCard();
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(SuperMemo2Loss(SuperMemo2Parameters(), histories));
+    }
+
+    state.SetItemsProcessed(state.iterations() * histories.Answers());
+}
+
+BENCHMARK(BM_SuperMemo2Loss)->RangeMultiplier(10)->Range(1000, 100000);
@@ -0,0 +1,107 @@
+// -- StudySession::NextReview and UpdateCard, through the polymorphic session and the SM-2 specialized one...
+
+#include "BenchmarkDecks.h"
+#include <benchmark/benchmark.h>
+
+using namespace jlimdev;
+
+// -- study the whole deck through, answering every due card; reports reviews per second...
+template <typename Session>
+static void BM_StudyDeck(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const uint duePercent = static_cast<uint>(state.range(1));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, duePercent);
+
+    SuperMemo2ReviewStrategy strategy;
+    Session session(strategy, deckSize, deckSize, deckSize);
+    int64_t reviews = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        session.Reset();
+        session.ImportRecords(deck.data(), deckSize);
+        state.ResumeTiming();
+
+        while (std::optional<uint> i = session.NextReview(benchmarkNow))
+        {
+            session.UpdateCard(*i, ReviewOutcome::Hesitant, benchmarkNow);
+            reviews++;
+        }
+    }
+
+    state.SetItemsProcessed(reviews);
+}
+
+BENCHMARK_TEMPLATE(BM_StudyDeck, StudySession)->ArgsProduct({ { 100, 1000, 10000, 100000 }, { 1, 10, 50, 100 } });
+BENCHMARK_TEMPLATE(BM_StudyDeck, SuperMemo2StudySession)->ArgsProduct({ { 100, 1000, 10000, 100000 }, { 1, 10, 50, 100 } });
+
+// -- NextReview once the session has nothing left to hand out, the call a polling client makes most...
+static void BM_NextReviewNothingDue(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 0);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+    session.ImportRecords(deck.data(), deckSize);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(session.NextReview(benchmarkNow));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_NextReviewNothingDue)->RangeMultiplier(10)->Range(100, 100000);
+
+// -- answering cards in deck order, wrong every so often so the wrong queue gets its share...
+static void BM_UpdateCard(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 50);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+    session.ImportRecords(deck.data(), deckSize);
+
+    uint i = 0;
+
+    for (auto _ : state)
+    {
+        const ReviewOutcome outcome = (i % 7 == 0) ? ReviewOutcome::Incorrect : ReviewOutcome::Hesitant;
+
+        benchmark::DoNotOptimize(session.UpdateCard(i, outcome, benchmarkNow));
+        i = (i + 1 == deckSize) ? 0 : i + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_UpdateCard)->RangeMultiplier(10)->Range(100, 100000);
+
+// -- a month's due counts, on the calling thread and then one thread per core, to tune ForecastCardsPerThread...
+static void BM_ForecastDueCounts(benchmark::State& state)
+{
+    const uint deckSize = static_cast<uint>(state.range(0));
+    const uint threads = static_cast<uint>(state.range(1));
+    const std::vector<DeckRecord> deck = BenchmarkDeck(deckSize, 50);
+
+    SuperMemo2ReviewStrategy strategy;
+    SuperMemo2StudySession session(strategy, deckSize, deckSize, deckSize);
+    session.ImportRecords(deck.data(), deckSize);
+
+    std::vector<uint> counts(30);
+
+    for (auto _ : state)
+    {
+        session.ForecastDueCounts(benchmarkNow, static_cast<uint>(counts.size()), counts.data(), threads);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * deckSize);
+}
+
+BENCHMARK(BM_ForecastDueCounts)->ArgsProduct({ { 1000, 10000, 100000, 1000000 }, { 1, 0 } });
@@ -0,0 +1,202 @@
+#include "Dejavu.h"
+
+using namespace jlimdev;
+
+constexpr Timestamp secondsPerDay = 24 * 60 * 60;
+
+// -- how far below the earliest date a rebased epoch goes, so dates a little older can still come in...
+constexpr Timestamp rebaseMargin = 7 * secondsPerDay;
+
+// -- one row of the store, with unused fields left at zero...
+struct CardRow
+{
+    CardState state;
+    uint8_t difficultyRating;
+    Timestamp reviewDate;
+    Timestamp previousCorrectReview;
+};
+
+// -- ratings are 0..100 by definition, which is what lets them fit in a byte...
+static uint8_t NarrowDifficulty(DifficultyRating difficultyRating) noexcept
+{
+    return static_cast<uint8_t>(difficultyRating > DifficultyRatingMostDifficult ? DifficultyRatingMostDifficult : difficultyRating);
+}
+
+// -- pattern match variant into its columns...
+struct CardRowFromItem
+{
+    CardRow operator()(const NeverReviewed& n)
+    {
+        return CardRow{ CardState::NeverReviewed, NarrowDifficulty(n.difficultyRating), 0, 0 };
+    }
+    CardRow operator()(const PreviouslyIncorrect& p)
+    {
+        return CardRow{ CardState::PreviouslyIncorrect, NarrowDifficulty(p.difficultyRating), p.reviewDate, 0 };
+    }
+    CardRow operator()(const PreviouslyFirstCorrect& p)
+    {
+        return CardRow{ CardState::PreviouslyFirstCorrect, NarrowDifficulty(p.difficultyRating), p.reviewDate, 0 };
+    }
+    CardRow operator()(const PreviouslyCorrect& p)
+    {
+        return CardRow{ CardState::PreviouslyCorrect, NarrowDifficulty(p.difficultyRating), p.reviewDate, p.previousCorrectReview };
+    }
+};
+
+void CardStore::Reserve(uint count)
+{
+    _state.reserve(count);
+    _difficultyRating.reserve(count);
+    _reviewDate.reserve(count);
+    _previousCorrectReview.reserve(count);
+}
+
+// -- a deck is empty between sessions, so it can start over from the unix epoch...
+void CardStore::Clear() noexcept
+{
+    _epoch = 0;
+    _state.clear();
+    _difficultyRating.clear();
+    _reviewDate.clear();
+    _previousCorrectReview.clear();
+}
+
+// -- replace the whole deck with columns laid out the same way, one copy per column...
+void CardStore::Assign(const CardState* state, const uint8_t* difficultyRating,
+    const DeckTime* reviewDate, const DeckTime* previousCorrectReview, uint count, Timestamp epoch)
+{
+    _epoch = epoch;
+    _state.assign(state, state + count);
+    _difficultyRating.assign(difficultyRating, difficultyRating + count);
+    _reviewDate.assign(reviewDate, reviewDate + count);
+    _previousCorrectReview.assign(previousCorrectReview, previousCorrectReview + count);
+}
+
+// -- same as Assign, but reading the columns where they are, until the deck changes...
+void CardStore::Borrow(const CardState* state, const uint8_t* difficultyRating,
+    const DeckTime* reviewDate, const DeckTime* previousCorrectReview, uint count, Timestamp epoch) noexcept
+{
+    _epoch = epoch;
+    _state.Borrow(state, count);
+    _difficultyRating.Borrow(difficultyRating, count);
+    _reviewDate.Borrow(reviewDate, count);
+    _previousCorrectReview.Borrow(previousCorrectReview, count);
+}
+
+// -- copy borrowed columns in, e.g. before what they were borrowed from goes away...
+void CardStore::Own()
+{
+    _state.Own(_state.size());
+    _difficultyRating.Own(_difficultyRating.size());
+    _reviewDate.Own(_reviewDate.size());
+    _previousCorrectReview.Own(_previousCorrectReview.size());
+}
+
+size_t CardStore::MemoryUsage() const noexcept
+{
+    return _state.capacity() * sizeof(CardState) + _difficultyRating.capacity() * sizeof(uint8_t) +
+        _reviewDate.capacity() * sizeof(DeckTime) + _previousCorrectReview.capacity() * sizeof(DeckTime);
+}
+
+void CardStore::Add(const ReviewItem& item)
+{
+    const CardRow row = std::visit(CardRowFromItem{}, item);
+
+    Add(row.state, row.difficultyRating, row.reviewDate, row.previousCorrectReview);
+}
+
+void CardStore::Add(CardState state, uint8_t difficultyRating, Timestamp reviewDate, Timestamp previousCorrectReview)
+{
+    _state.push_back(state);
+    _difficultyRating.push_back(difficultyRating);
+    _reviewDate.push_back(ToDeckTime(reviewDate));
+    _previousCorrectReview.push_back(ToDeckTime(previousCorrectReview));
+}
+
+void CardStore::Set(uint i, const ReviewItem& item)
+{
+    const CardRow row = std::visit(CardRowFromItem{}, item);
+
+    _state.Set(i, row.state);
+    _difficultyRating.Set(i, row.difficultyRating);
+    _reviewDate.Set(i, ToDeckTime(row.reviewDate));
+    _previousCorrectReview.Set(i, ToDeckTime(row.previousCorrectReview));
+}
+
+// -- rebuild the variant from the columns...
+ReviewItem CardStore::At(uint i) const
+{
+    const DifficultyRating difficultyRating = _difficultyRating.at(i);
+
+    switch (_state.at(i))
+    {
+    case CardState::NeverReviewed:
+    {
+        return NeverReviewed{ difficultyRating };
+    }
+    case CardState::PreviouslyIncorrect:
+    {
+        return PreviouslyIncorrect{ difficultyRating, FromDeckTime(_reviewDate[i]) };
+    }
+    case CardState::PreviouslyFirstCorrect:
+    {
+        return PreviouslyFirstCorrect{ difficultyRating, FromDeckTime(_reviewDate[i]) };
+    }
+    case CardState::PreviouslyCorrect:
+    default:
+    {
+        return PreviouslyCorrect{ difficultyRating, FromDeckTime(_reviewDate[i]), FromDeckTime(_previousCorrectReview[i]) };
+    }
+    }
+}
+
+// -- move the epoch so every date in the deck fits, along with earliest and latest, a margin below the earliest on a day boundary.
+// -- returns false, leaving the store as it was, when they span more than DeckTime can hold.
+bool CardStore::Rebase(Timestamp earliest, Timestamp latest) noexcept
+{
+    for (uint i = 0; i < Size(); i++)
+    {
+        const CardState state = _state[i];
+
+        if (state != CardState::NeverReviewed)
+        {
+            earliest = std::min(earliest, FromDeckTime(_reviewDate[i]));
+            latest = std::max(latest, FromDeckTime(_reviewDate[i]));
+        }
+
+        if (state == CardState::PreviouslyCorrect)
+        {
+            earliest = std::min(earliest, FromDeckTime(_previousCorrectReview[i]));
+            latest = std::max(latest, FromDeckTime(_previousCorrectReview[i]));
+        }
+    }
+
+    // -- dates that fit from the unix epoch stay there, so most decks never carry an epoch at all...
+    const Timestamp epoch = (latest <= DeckTimeMax || earliest <= rebaseMargin) ? 0 : (earliest - rebaseMargin) / secondsPerDay * secondsPerDay;
+
+    if (latest - epoch > DeckTimeMax)
+    {
+        return false;
+    }
+
+    DeckTime* reviewDates = _reviewDate.MutableData();
+    DeckTime* previousCorrectReviews = _previousCorrectReview.MutableData();
+
+    for (uint i = 0; i < Size(); i++)
+    {
+        // -- absent dates are zero, and stay zero...
+        if (reviewDates[i] != 0)
+        {
+            reviewDates[i] = static_cast<DeckTime>(FromDeckTime(reviewDates[i]) - epoch);
+        }
+
+        if (previousCorrectReviews[i] != 0)
+        {
+            previousCorrectReviews[i] = static_cast<DeckTime>(FromDeckTime(previousCorrectReviews[i]) - epoch);
+        }
+    }
+
+    _epoch = epoch;
+
+    return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <memory_resource>
+#include <variant>
+#include <type_traits>
+
+namespace jlimdev
+{
+    // -- tag for which ReviewItem alternative a card is in, same order as the variant...
+    enum class CardState : uint8_t
+    {
+        NeverReviewed,
+        PreviouslyIncorrect,
+        PreviouslyFirstCorrect,
+        PreviouslyCorrect
+    };
+
+    static_assert(std::is_same_v<std::variant_alternative_t<static_cast<size_t>(CardState::NeverReviewed), ReviewItem>, NeverReviewed>);
+    static_assert(std::is_same_v<std::variant_alternative_t<static_cast<size_t>(CardState::PreviouslyIncorrect), ReviewItem>, PreviouslyIncorrect>);
+    static_assert(std::is_same_v<std::variant_alternative_t<static_cast<size_t>(CardState::PreviouslyFirstCorrect), ReviewItem>, PreviouslyFirstCorrect>);
+    static_assert(std::is_same_v<std::variant_alternative_t<static_cast<size_t>(CardState::PreviouslyCorrect), ReviewItem>, PreviouslyCorrect>);
+
+    /// <summary>
+    /// Column-per-field storage for a deck, so scans only touch the fields they need.
+    /// Fields an alternative doesn't have are stored as zero. Columns are allocated from the given memory resource.
+    /// Dates are kept as DeckTime, seconds since the store's epoch, which starts at the unix epoch and only moves
+    /// when a date outside the 32 bits from it comes in (see Rebase), so any deck spanning less than 136 years fits.
+    /// Columns can also be borrowed from a snapshot image (see Borrow), and are only copied once the deck changes.
+    /// </summary>
+    class CardStore
+    {
+    private:
+        Timestamp _epoch;
+        Column<CardState> _state;
+        Column<uint8_t> _difficultyRating;
+        Column<DeckTime> _reviewDate;
+        Column<DeckTime> _previousCorrectReview;
+
+    public:
+        explicit CardStore(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept
+            : _epoch(0), _state(resource), _difficultyRating(resource), _reviewDate(resource), _previousCorrectReview(resource)
+        {
+        }
+
+        // -- a rebased epoch always sits below every date by a margin, so 0 is left to mean DueImmediately...
+        Timestamp Epoch() const noexcept { return _epoch; }
+        bool Fits(Timestamp t) const noexcept { return (t > _epoch || _epoch == 0) && t - _epoch <= DeckTimeMax; }
+
+        // -- DueImmediately stays 0, and times outside the deck's range clamp to its ends, which is where they sort anyway...
+        DeckTime ToDeckTime(Timestamp t) const noexcept
+        {
+            if (t <= _epoch)
+            {
+                return (t == DueImmediately) ? 0 : 1;
+            }
+
+            return (t - _epoch > DeckTimeMax) ? DeckTimeMax : static_cast<DeckTime>(t - _epoch);
+        }
+
+        Timestamp FromDeckTime(DeckTime t) const noexcept { return (t == 0) ? DueImmediately : _epoch + t; }
+
+        bool Rebase(Timestamp earliest, Timestamp latest) noexcept;
+
+        uint Size() const noexcept { return static_cast<uint>(_state.size()); }
+        void Reserve(uint count);
+        void Clear() noexcept;
+        size_t MemoryUsage() const noexcept;
+
+        void Add(const ReviewItem& item);
+        void Add(CardState state, uint8_t difficultyRating, Timestamp reviewDate, Timestamp previousCorrectReview);
+        void Set(uint i, const ReviewItem& item);
+        void Assign(const CardState* state, const uint8_t* difficultyRating,
+            const DeckTime* reviewDate, const DeckTime* previousCorrectReview, uint count, Timestamp epoch);
+        void Borrow(const CardState* state, const uint8_t* difficultyRating,
+            const DeckTime* reviewDate, const DeckTime* previousCorrectReview, uint count, Timestamp epoch) noexcept;
+        void Own();
+        bool Borrowed() const noexcept { return _state.Borrowed(); }
+        ReviewItem At(uint i) const;
+
+        CardState State(uint i) const { return _state.at(i); }
+        DifficultyRating Difficulty(uint i) const { return _difficultyRating.at(i); }
+        Timestamp ReviewDate(uint i) const { return FromDeckTime(_reviewDate.at(i)); }
+        Timestamp PreviousCorrectReview(uint i) const { return FromDeckTime(_previousCorrectReview.at(i)); }
+
+        // -- the raw columns, dates in DeckTime...
+        const Column<CardState>& States() const noexcept { return _state; }
+        const Column<uint8_t>& DifficultyRatings() const noexcept { return _difficultyRating; }
+        const Column<DeckTime>& ReviewDates() const noexcept { return _reviewDate; }
+        const Column<DeckTime>& PreviousCorrectReviews() const noexcept { return _previousCorrectReview; }
+    };
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+namespace jlimdev
+{
+    /// <summary>
+    /// One column of per-card values, either owned in a vector from the given memory resource, or borrowed
+    /// read-only from memory someone else keeps alive, such as a MappedSnapshot. Reads never copy; the first
+    /// write, or anything that changes the size, copies a borrowed column into owned storage first.
+    /// Writes go through Set or MutableData, so reading from a non-const column can't copy it by accident.
+    /// </summary>
+    template <typename T>
+    class Column
+    {
+    private:
+        std::pmr::vector<T> _owned;
+        const T* _borrowed;
+        size_t _borrowedSize;
+
+    public:
+        explicit Column(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept
+            : _owned(resource), _borrowed(nullptr), _borrowedSize(0)
+        {
+        }
+
+        Column(const Column&) = delete;
+        Column& operator=(const Column&) = delete;
+
+        bool Borrowed() const noexcept { return _borrowed != nullptr; }
+        size_t size() const noexcept { return Borrowed() ? _borrowedSize : _owned.size(); }
+        bool empty() const noexcept { return size() == 0; }
+        // -- only what the column owns, borrowed memory belongs to whoever lent it...
+        size_t capacity() const noexcept { return _owned.capacity(); }
+
+        const T* data() const noexcept { return Borrowed() ? _borrowed : _owned.data(); }
+        const T* begin() const noexcept { return data(); }
+        const T* end() const noexcept { return data() + size(); }
+        const T& operator[](size_t i) const noexcept { return data()[i]; }
+
+        const T& at(size_t i) const
+        {
+            if (i >= size())
+            {
+                throw std::out_of_range("Column::at");
+            }
+
+            return data()[i];
+        }
+
+        T* MutableData()
+        {
+            Own(size());
+            return _owned.data();
+        }
+
+        void Set(size_t i, const T& value)
+        {
+            Own(size());
+            _owned.at(i) = value;
+        }
+
+        void push_back(const T& value)
+        {
+            Own(size() + 1);
+            _owned.push_back(value);
+        }
+
+        void resize(size_t count)
+        {
+            Own(count);
+            _owned.resize(count);
+        }
+
+        void reserve(size_t count)
+        {
+            Own(count);
+            _owned.reserve(count);
+        }
+
+        // -- owned storage is kept, so a cleared column refills without allocating...
+        void clear() noexcept
+        {
+            _borrowed = nullptr;
+            _borrowedSize = 0;
+            _owned.clear();
+        }
+
+        void assign(const T* first, const T* last)
+        {
+            clear();
+            _owned.assign(first, last);
+        }
+
+        // -- values must stay valid until the column is written to, cleared, or borrows or assigns again...
+        void Borrow(const T* values, size_t count) noexcept
+        {
+            clear();
+            _borrowed = values;
+            _borrowedSize = count;
+        }
+
+        void Own(size_t capacity)
+        {
+            if (!Borrowed())
+            {
+                return;
+            }
+
+            const T* values = _borrowed;
+            const size_t count = _borrowedSize;
+
+            clear();
+            _owned.reserve(std::max(capacity, count));
+            _owned.assign(values, values + count);
+        }
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace jlimdev
+{
+    /// <summary>
+    /// Fixed-width card record for moving whole decks in and out in one go.
+    /// Layout is shared with javascript, which reads and writes it straight in the module heap:
+    ///   byte 0 state (CardState), byte 1 difficulty rating, bytes 8-15 review date, bytes 16-23 previous correct review,
+    ///   bytes 2-7 unused.
+    /// </summary>
+    struct DeckRecord
+    {
+        CardState state;
+        uint8_t difficultyRating;
+        uint16_t reserved;
+        Timestamp reviewDate;
+        Timestamp previousCorrectReview;
+    };
+
+    static_assert(sizeof(DeckRecord) == 24);
+    static_assert(offsetof(DeckRecord, reviewDate) == 8);
+
+    /// <summary>
+    /// A card on its way out, with its position in the deck and the next review time its strategy gave it.
+    /// Five 64-bit words, the index in the low half of the fourth, so javascript can read a whole export as one BigUint64Array.
+    /// </summary>
+    struct ExportedRecord
+    {
+        DeckRecord card;
+        uint index;
+        Timestamp nextReview;
+    };
+
+    static_assert(sizeof(ExportedRecord) == 40);
+}
@@ -3,7 +3,9 @@
 // ported from https://github.com/helephant/SpacedRepetition.Net
 
 #include "Dejavu.h"
+#include <cmath>
 #include <memory>
+#include <vector>
 
 #if __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
@@ -14,15 +16,39 @@ using namespace jlimdev;
 constexpr uint maxNewCardsInSession = 15;
 constexpr uint maxExistingCardsInSession = 15;
 constexpr uint maxCards = 10000;
+// -- javascript numbers hold whole seconds exactly up to 2^53...
+constexpr double maxTimestampJs = 9007199254740992.0;
 
-StudySession& session() noexcept {
+SuperMemo2StudySession& session() noexcept {
     // workaround for keeping global initialization in sequence with strategy constructed before session...
     static SuperMemo2ReviewStrategy strategy;
-    static StudySession session(strategy, maxNewCardsInSession, maxExistingCardsInSession, maxCards);
+    static SuperMemo2StudySession session(strategy, maxNewCardsInSession, maxExistingCardsInSession, maxCards);
 
     return session;
 }
 
+SuperMemo2MultiDeckSession& multiDeckSession() noexcept {
+    // -- same caps as the single deck session, shared by every deck the page adds...
+    static SuperMemo2ReviewStrategy strategy;
+    static SuperMemo2MultiDeckSession session(strategy, maxNewCardsInSession, maxExistingCardsInSession, maxCards);
+
+    return session;
+}
+
+uint& lastPickedDeck() noexcept {
+    // -- the deck of the card NextFromDecks returned last, for javascript to ask after...
+    static uint deck = 0;
+
+    return deck;
+}
+
+std::vector<ExportedRecord>& exportBuffer() noexcept {
+    // -- kept between calls so javascript can read it after ExportDeck returns...
+    static std::vector<ExportedRecord> buffer;
+
+    return buffer;
+}
+
 // -- bridges back and forth to javascript...
 
 struct DownloadHelper
@@ -42,7 +68,7 @@ struct DownloadHelper
     void operator()(PreviouslyIncorrect p)
     {
         const int param0 = p.difficultyRating;
-        const int param1 = p.reviewDate;
+        const double param1 = static_cast<double>(p.reviewDate);
 
 #if __EMSCRIPTEN__
         EM_ASM(
@@ -57,7 +83,7 @@ struct DownloadHelper
     void operator()(PreviouslyFirstCorrect p)
     {
         const int param0 = p.difficultyRating;
-        const int param1 = p.reviewDate;
+        const double param1 = static_cast<double>(p.reviewDate);
 
 #if __EMSCRIPTEN__
         EM_ASM(
@@ -72,8 +98,8 @@ struct DownloadHelper
     void operator()(PreviouslyCorrect p)
     {
         const int param0 = p.difficultyRating;
-        const int param1 = p.reviewDate;
-        const int param2 = p.previousCorrectReview;
+        const double param1 = static_cast<double>(p.reviewDate);
+        const double param2 = static_cast<double>(p.previousCorrectReview);
 
 #if __EMSCRIPTEN__
         EM_ASM(
@@ -88,26 +114,35 @@ struct DownloadHelper
     }
 };
 
-void ConvertDifficultyRatingAndReviewDate(int difficultyRatingJs, i64 reviewDateJs,
+void ConvertDifficultyRatingAndReviewDate(int difficultyRatingJs, double reviewDateJs,
     DifficultyRating& difficultyRating, Timestamp& reviewDate)
 {    
     if (difficultyRatingJs < 0 ||
         difficultyRatingJs > 100)
         exit(2);
 
-    if (reviewDateJs < 0)
+    if (!(reviewDateJs >= 0) || reviewDateJs > maxTimestampJs)
         exit(3);
 
-    reviewDate = static_cast<Timestamp>(reviewDateJs);
+    reviewDate = static_cast<Timestamp>(std::floor(reviewDateJs));
     difficultyRating = static_cast<uint>(difficultyRatingJs);
 }
 
-uint ConvertNow(i64 nowJs)
+// -- timestamps come over as doubles, seconds since the unix epoch, so they go well past 2038...
+Timestamp ConvertNow(double nowJs)
 {
-    if (nowJs < 0 || nowJs > UINT32_MAX)
+    if (!(nowJs >= 0) || nowJs > maxTimestampJs)
         exit(1);
 
-    return static_cast<uint>(nowJs);
+    return static_cast<Timestamp>(std::floor(nowJs));
+}
+
+uint ConvertCount(int countJs)
+{
+    if (countJs < 0 || countJs > maxCards)
+        exit(1);
+
+    return static_cast<uint>(countJs);
 }
 
 uint ConvertIndex(int iJs)
@@ -118,15 +153,54 @@ uint ConvertIndex(int iJs)
     return static_cast<uint>(iJs);
 }
 
+ReviewOutcome ConvertOutcome(int userState)
+{
+    ReviewOutcome outcome = ReviewOutcome::Incorrect;
+
+    switch (userState)
+    {
+    case 1 : 
+    {
+        outcome = ReviewOutcome::Incorrect;
+        break;
+    }
+    case 2 : 
+    {
+        outcome = ReviewOutcome::Hesitant;
+        break;
+    }
+    case 3 : 
+    {
+        outcome = ReviewOutcome::Perfect;
+        break;
+    }
+    default :
+    {
+        exit(1);
+    }
+    }
+
+    return outcome;
+}
+
+uint ConvertDeck(int deckJs)
+{
+    if (deckJs < 0)
+        exit(1);
+
+    return static_cast<uint>(deckJs);
+}
+
 
 extern "C" {
 
     void AddNeverReviewedCard()
     {
-        session().AddNeverReviewed();
+        if (!session().AddNeverReviewed())
+            exit(1);
     }
 
-    void AddPreviouslyIncorrect(int difficultyRatingJs, int reviewDateJs)
+    void AddPreviouslyIncorrect(int difficultyRatingJs, double reviewDateJs)
     {
         Timestamp reviewDate;
         DifficultyRating difficultyRating;
@@ -134,10 +208,11 @@ extern "C" {
         ConvertDifficultyRatingAndReviewDate(difficultyRatingJs, reviewDateJs,
             difficultyRating, reviewDate);
 
-        session().AddPreviouslyIncorrect(difficultyRating, reviewDate);
+        if (!session().AddPreviouslyIncorrect(difficultyRating, reviewDate))
+            exit(1);
     }
 
-    void AddPreviouslyFirstCorrect(int difficultyRatingJs, int reviewDateJs)
+    void AddPreviouslyFirstCorrect(int difficultyRatingJs, double reviewDateJs)
     {
         Timestamp reviewDate;
         uint difficultyRating;
@@ -145,12 +220,13 @@ extern "C" {
         ConvertDifficultyRatingAndReviewDate(difficultyRatingJs, reviewDateJs,
             difficultyRating, reviewDate);
 
-        session().AddPreviouslyFirstCorrect(difficultyRating, reviewDate);
+        if (!session().AddPreviouslyFirstCorrect(difficultyRating, reviewDate))
+            exit(1);
     }
 
-    void AddPreviouslyCorrect(int difficultyRatingJs, int reviewDateJs, int previousCorrectReviewJs)
+    void AddPreviouslyCorrect(int difficultyRatingJs, double reviewDateJs, double previousCorrectReviewJs)
     {
-        if (previousCorrectReviewJs <= 0)
+        if (!(previousCorrectReviewJs >= 1) || previousCorrectReviewJs > maxTimestampJs)
             exit(1);
 
         Timestamp reviewDate;
@@ -159,47 +235,25 @@ extern "C" {
         ConvertDifficultyRatingAndReviewDate(difficultyRatingJs, reviewDateJs,
             difficultyRating, reviewDate);
 
-        const Timestamp previousCorrectReview = static_cast<Timestamp>(previousCorrectReviewJs);
+        const Timestamp previousCorrectReview = static_cast<Timestamp>(std::floor(previousCorrectReviewJs));
 
-        session().AddPreviouslyCorrect(difficultyRating, reviewDate, previousCorrectReviewJs);
+        if (!session().AddPreviouslyCorrect(difficultyRating, reviewDate, previousCorrectReview))
+            exit(1);
     }
 
-    void SetOutcome(int iJs, int userState, int nowJs)
+    void SetOutcome(int iJs, int userState, double nowJs)
     {
         const uint i = ConvertIndex(iJs);
-        const uint now = ConvertNow(nowJs);
+        const Timestamp now = ConvertNow(nowJs);
+        const ReviewOutcome outcome = ConvertOutcome(userState);
 
-        ReviewOutcome outcome = ReviewOutcome::Incorrect;
-
-        switch (userState)
-        {
-        case 1 : 
-        {
-            outcome = ReviewOutcome::Incorrect;
-            break;
-        }
-        case 2 : 
-        {
-            outcome = ReviewOutcome::Hesitant;
-            break;
-        }
-        case 3 : 
-        {
-            outcome = ReviewOutcome::Perfect;
-            break;
-        }
-        default :
-        {
+        if (!session().UpdateCard(i, outcome, now))
             exit(1);
-        }
-        }
-
-        session().UpdateCard(i, outcome, now);
     }
 
-    int Next(int nowJs)
+    int Next(double nowJs)
     {
-        const uint now = ConvertNow(nowJs);
+        const Timestamp now = ConvertNow(nowJs);
 
         return session().NextReview(now).value_or(-1);
     }
@@ -211,12 +265,12 @@ extern "C" {
         std::visit(DownloadHelper{ i }, session().At(i));
     }
 
-    void GetNextTime(int iJs, int nowJs)
+    void GetNextTime(int iJs, double nowJs)
     {
         const uint i = ConvertIndex(iJs);
-        const uint now = ConvertNow(nowJs);
+        const Timestamp now = ConvertNow(nowJs);
 
-        auto time = session().GetNextReviewTime(i, now);
+        const double time = static_cast<double>(session().GetNextReviewTime(i, now));
 
 #if __EMSCRIPTEN__
         EM_ASM(
@@ -232,6 +286,203 @@ extern "C" {
     {
         session().Reset();
     }
+
+    // -- 0 round robin, 1 most overdue first, 2 hardest first, 3 shortest interval first, see ReviewOrder...
+    void SetReviewOrder(int orderJs)
+    {
+        if (orderJs < 0 || orderJs > static_cast<int>(ReviewOrder::ShortestInterval))
+            exit(1);
+
+        session().SetReviewOrder(static_cast<ReviewOrder>(orderJs));
+    }
+
+    // -- bulk deck load: javascript asks for a buffer, writes DeckRecords into it (24 bytes each, see DeckRecord.h),
+    // -- then hands it back to ImportDeck, so a whole deck crosses over in two calls instead of one per card...
+    DeckRecord* GetImportBuffer(int countJs)
+    {
+        static std::vector<DeckRecord> importBuffer;
+
+        importBuffer.resize(ConvertCount(countJs));
+
+        return importBuffer.data();
+    }
+
+    // -- for pages that still add cards one at a time: room for the whole deck up front, so the adds never reallocate...
+    void ReserveDeck(int countJs)
+    {
+        session().Reserve(ConvertCount(countJs));
+    }
+
+    void ImportDeck(const DeckRecord* records, int countJs)
+    {
+        const uint count = ConvertCount(countJs);
+
+        if (session().ImportRecords(records, count) != count)
+            exit(2);
+    }
+
+    // -- streaming load for big decks, so the first card doesn't wait on the whole deck: StreamDeck with the size of
+    // -- the whole deck, then ImportDeckChunk for each chunk as it arrives, through the GetImportBuffer buffer.
+    // -- Next works from the first chunk on. with pullJs set, Next also asks for the next chunk itself, through
+    // -- cppLoadDeckChunk, before it would pass over cards not loaded yet; javascript answers with ImportDeckChunk,
+    // -- or returns 0 when it has nothing more...
+    void StreamDeck(int countJs, int pullJs)
+    {
+        SuperMemo2StudySession::ChunkLoader loader;
+
+        if (pullJs != 0)
+        {
+            loader = [](SuperMemo2StudySession&)
+            {
+#if __EMSCRIPTEN__
+                return EM_ASM_INT(return cppLoadDeckChunk() ? 1 : 0;) != 0;
+#else
+                return false;
+#endif
+            };
+        }
+
+        session().StreamDeck(ConvertCount(countJs), std::move(loader));
+    }
+
+    // -- returns how many cards are still to come, 0 once the deck is all in; a deck streamed past the card limit
+    // -- is cut off there, the same as StreamDeck cut its size, so only a bad record stops the import short...
+    int ImportDeckChunk(const DeckRecord* records, int countJs)
+    {
+        const uint count = std::min(ConvertCount(countJs), session().StreamedSize() - session().Size());
+
+        if (session().ImportRecords(records, count) != count)
+            exit(2);
+
+        return static_cast<int>(session().StreamedSize() - session().Size());
+    }
+
+    // -- bulk save: every card and its next review time written into one buffer in the module heap,
+    // -- javascript reads ExportDeckCount() records of 40 bytes each (see ExportedRecord) from the returned pointer...
+    ExportedRecord* ExportDeck(double nowJs)
+    {
+        const Timestamp now = ConvertNow(nowJs);
+
+        exportBuffer().resize(session().Size());
+        session().ExportRecords(now, exportBuffer().data());
+
+        return exportBuffer().data();
+    }
+
+    // -- number of records written by the last ExportDeck or ExportDirtyCards...
+    int ExportDeckCount()
+    {
+        return static_cast<int>(exportBuffer().size());
+    }
+
+    // -- incremental save: same layout as ExportDeck but only the cards answered since the last commit,
+    // -- each record carries its deck index so javascript can patch its copy in place...
+    ExportedRecord* ExportDirtyCards(double nowJs)
+    {
+        const Timestamp now = ConvertNow(nowJs);
+
+        exportBuffer().resize(session().DirtyCards().size());
+        session().ExportDirtyRecords(now, exportBuffer().data());
+
+        return exportBuffer().data();
+    }
+
+    // -- javascript has stored the dirty cards...
+    void CommitDirtyCards()
+    {
+        session().CommitDirtyCards();
+    }
+
+    // -- cards coming due on each of the next daysJs days, read back as a Uint32Array of daysJs counts,
+    // -- spread over the cores when the module is built with pthreads and the deck is big enough to be worth it...
+    uint* ForecastDueCounts(double nowJs, int daysJs)
+    {
+        static std::vector<uint> forecastBuffer;
+
+        const Timestamp now = ConvertNow(nowJs);
+
+        forecastBuffer.resize(ConvertCount(daysJs));
+        session().ForecastDueCounts(now, static_cast<uint>(forecastBuffer.size()), forecastBuffer.data(), 0);
+
+        return forecastBuffer.data();
+    }
+
+    // -- several decks studied at once: each deck is added and filled on its own, from the GetImportBuffer buffer,
+    // -- and can be removed again without reloading the others...
+    void AddDeck(int deckJs, const DeckRecord* records, int countJs)
+    {
+        const uint count = ConvertCount(countJs);
+        SuperMemo2StudySession* deck = multiDeckSession().AddDeck(ConvertDeck(deckJs));
+
+        if (deck == nullptr)
+            exit(1);
+
+        if (deck->ImportRecords(records, count) != count)
+            exit(2);
+    }
+
+    void RemoveDeck(int deckJs)
+    {
+        multiDeckSession().RemoveDeck(ConvertDeck(deckJs));
+    }
+
+    // -- next card from any deck, or -1 when done; NextDeckOfLastCard says which deck it is from...
+    int NextFromDecks(double nowJs)
+    {
+        const Timestamp now = ConvertNow(nowJs);
+        const std::optional<DeckCard> next = multiDeckSession().NextReview(now);
+
+        if (!next)
+            return -1;
+
+        lastPickedDeck() = next->deck;
+
+        return static_cast<int>(next->card);
+    }
+
+    int NextDeckOfLastCard()
+    {
+        return static_cast<int>(lastPickedDeck());
+    }
+
+    void SetDeckOutcome(int deckJs, int iJs, int userState, double nowJs)
+    {
+        const DeckCard card{ ConvertDeck(deckJs), ConvertIndex(iJs) };
+        const Timestamp now = ConvertNow(nowJs);
+
+        multiDeckSession().UpdateCard(card, ConvertOutcome(userState), now);
+    }
+
+    // -- same as ExportDeck, for one deck of the multi-deck session...
+    ExportedRecord* ExportFromDeck(int deckJs, double nowJs)
+    {
+        const Timestamp now = ConvertNow(nowJs);
+        const SuperMemo2StudySession* deck = multiDeckSession().FindDeck(ConvertDeck(deckJs));
+
+        if (deck == nullptr)
+            exit(1);
+
+        exportBuffer().resize(deck->Size());
+        deck->ExportRecords(now, exportBuffer().data());
+
+        return exportBuffer().data();
+    }
+
+    // -- instrumentation summed over every thread, read back as a BigUint64Array laid out like DejavuStats:
+    // -- the counters in StatCounter order, then StatHistogramBuckets buckets per histogram. all zeros unless built with DEJAVU_STATS=1...
+    const DejavuStats* GetStats()
+    {
+        static DejavuStats stats;
+
+        jlimdev::GetStats(stats);
+
+        return &stats;
+    }
+
+    void ResetStats()
+    {
+        jlimdev::ResetStats();
+    }
 }
 
 // main
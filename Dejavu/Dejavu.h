@@ -1,8 +1,20 @@
 #pragma once
 
 #include "ReviewItem.h"
+#include "Stats.h"
+#include "Column.h"
+#include "CardStore.h"
+#include "DeckRecord.h"
+#include "Snapshot.h"
 #include "ReviewStrategies.h"
+#include "ReviewLog.h"
+#include "DueForecast.h"
+#include "SuperMemo2Optimizer.h"
 #include "StudySession.h"
+#include "SessionManager.h"
+#include "ShardedSessionManager.h"
+#include "DueScheduler.h"
+#include "MultiDeckSession.h"
 
 using i64 = int64_t;
 
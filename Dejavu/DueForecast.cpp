@@ -0,0 +1,74 @@
+#include "Dejavu.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace jlimdev;
+
+constexpr DeckTime secondsPerDay = 24 * 60 * 60;
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+constexpr bool threadsAvailable = false;
+#else
+constexpr bool threadsAvailable = true;
+#endif
+
+static void CountDueDays(const DeckTime* dueAt, size_t count, DeckTime now, uint days, uint* counts) noexcept
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const DeckTime day = (dueAt[i] <= now) ? 0 : (dueAt[i] - now) / secondsPerDay;
+
+        if (day < days)
+        {
+            counts[day]++;
+        }
+    }
+}
+
+void jlimdev::ForecastDueCounts(const DeckTime* dueAt, size_t count, DeckTime now, uint days, uint* counts, uint threads)
+{
+    std::fill(counts, counts + days, 0U);
+
+    // -- decided before asking for the core count, which can cost more than counting a small deck...
+    const size_t mostWorkers = threadsAvailable ? count / ForecastCardsPerThread : 1;
+
+    if (threads == 0 && mostWorkers > 1)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    const size_t workers = std::min<size_t>(threads, std::max<size_t>(mostWorkers, 1));
+
+    if (workers <= 1)
+    {
+        CountDueDays(dueAt, count, now, days, counts);
+        return;
+    }
+
+    // -- one histogram per worker, so nothing is shared until they're summed...
+    std::vector<uint> histograms(workers * days, 0U);
+    std::vector<std::thread> pool;
+    const size_t run = (count + workers - 1) / workers;
+
+    for (size_t w = 0; w < workers; w++)
+    {
+        const size_t first = std::min(w * run, count);
+        const size_t last = std::min(first + run, count);
+
+        pool.emplace_back(CountDueDays, dueAt + first, last - first, now, days, histograms.data() + w * days);
+    }
+
+    for (std::thread& worker : pool)
+    {
+        worker.join();
+    }
+
+    for (size_t w = 0; w < workers; w++)
+    {
+        for (uint day = 0; day < days; day++)
+        {
+            counts[day] += histograms[w * days + day];
+        }
+    }
+}
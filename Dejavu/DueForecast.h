@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace jlimdev
+{
+    // -- fewest cards worth a thread of their own: counting takes about 2ns a card, and starting and joining
+    // -- a thread about 30us, so a second thread only pays for itself from somewhere past 30000 cards.
+    // -- see BM_ForecastDueCounts to measure it again...
+    constexpr size_t ForecastCardsPerThread = 32 * 1024;
+
+    // -- how many of the due times fall on each of the next days days, counted in whole days from now:
+    // -- counts[0] is everything due within a day of now, overdue and DueImmediately cards included,
+    // -- and cards due after the horizon aren't counted. counts must have room for days entries.
+    // -- due times and now are deck times, see CardStore::ToDeckTime.
+    // -- threads of 0 means one per core, and builds without threads, like WebAssembly without pthreads,
+    // -- always count on the calling thread; the deck is split into contiguous runs, each counted into
+    // -- its own histogram, and the histograms summed once every thread is done.
+    void ForecastDueCounts(const DeckTime* dueAt, size_t count, DeckTime now, uint days, uint* counts, uint threads);
+}
@@ -0,0 +1,270 @@
+#include "Dejavu.h"
+
+using namespace jlimdev;
+
+DueTimingWheel::DueTimingWheel(Timestamp now, Timestamp tickSeconds)
+    : _tickSeconds(std::max<Timestamp>(tickSeconds, 1)), _currentTick(0), _size(0)
+{
+    _currentTick = now / _tickSeconds;
+}
+
+// -- rounded up, so the slot a card lands in never comes around before the card is due...
+uint64_t DueTimingWheel::TickOf(Timestamp dueAt) const noexcept
+{
+    return (static_cast<uint64_t>(dueAt) + _tickSeconds - 1) / _tickSeconds;
+}
+
+void DueTimingWheel::Schedule(const DueCard& card)
+{
+    _size++;
+    Place(card);
+}
+
+// -- the level is the lowest one where the card's tick and the current tick share every coarser digit,
+// -- so the slot at that level comes around before the one at any level below would wrap past it...
+void DueTimingWheel::Place(const DueCard& card)
+{
+    const uint64_t tick = TickOf(card.dueAt);
+
+    if (tick <= _currentTick)
+    {
+        _ready.push_back(card);
+        return;
+    }
+
+    for (uint level = 0; level < Levels; level++)
+    {
+        const uint shift = SlotBits * (level + 1);
+
+        if ((tick >> shift) == (_currentTick >> shift))
+        {
+            _slots[level][(tick >> (SlotBits * level)) & (Slots - 1)].push_back(card);
+            return;
+        }
+    }
+
+    _overflow.push_back(card);
+}
+
+// -- one tick has passed: every level whose slot just turned over spills that slot into the levels below...
+void DueTimingWheel::Cascade()
+{
+    std::vector<DueCard> spilled;
+
+    for (uint level = 1; level < Levels; level++)
+    {
+        if ((_currentTick & ((uint64_t(1) << (SlotBits * level)) - 1)) != 0)
+        {
+            break;
+        }
+
+        std::vector<DueCard>& slot = _slots[level][(_currentTick >> (SlotBits * level)) & (Slots - 1)];
+        spilled.insert(spilled.end(), slot.begin(), slot.end());
+        slot.clear();
+
+        if (level == Levels - 1)
+        {
+            spilled.insert(spilled.end(), _overflow.begin(), _overflow.end());
+            _overflow.clear();
+        }
+    }
+
+    for (const DueCard& card : spilled)
+    {
+        Place(card);
+    }
+}
+
+void DueTimingWheel::Fire(std::vector<DueCard>& slot, const std::function<void(const DueCard& card)>& due)
+{
+    // -- swapped out first, since the callback may well schedule more cards...
+    // -- counted off one at a time, so the cards still to come stay in Size if the callback looks...
+    std::vector<DueCard> firing;
+    firing.swap(slot);
+
+    for (const DueCard& card : firing)
+    {
+        _size--;
+        due(card);
+    }
+}
+
+// -- hand every card due by now to due, oldest tick first; an empty wheel jumps straight to now...
+void DueTimingWheel::Advance(Timestamp now, const std::function<void(const DueCard& card)>& due)
+{
+    const uint64_t target = now / _tickSeconds;
+
+    Fire(_ready, due);
+
+    while (_currentTick < target)
+    {
+        if (_size == 0)
+        {
+            _currentTick = target;
+            break;
+        }
+
+        _currentTick++;
+        Cascade();
+
+        // -- cascading can only have placed cards due this tick into level 0 or ready...
+        Fire(_ready, due);
+        Fire(_slots[0][_currentTick & (Slots - 1)], due);
+    }
+}
+
+// -- drop every card matching remove, wherever it is in the wheel...
+size_t DueTimingWheel::Remove(const std::function<bool(const DueCard& card)>& remove)
+{
+    const size_t before = _size;
+
+    const auto sweep = [this, &remove](std::vector<DueCard>& slot)
+    {
+        const auto kept = std::remove_if(slot.begin(), slot.end(), remove);
+        _size -= static_cast<size_t>(slot.end() - kept);
+        slot.erase(kept, slot.end());
+    };
+
+    for (auto& level : _slots)
+    {
+        for (std::vector<DueCard>& slot : level)
+        {
+            sweep(slot);
+        }
+    }
+
+    sweep(_ready);
+    sweep(_overflow);
+
+    return before - _size;
+}
+
+DueScheduler::DueScheduler(Timestamp now, Timestamp tickSeconds)
+    : _wheel(now, tickSeconds), _nextGeneration(0), _stale(0)
+{
+}
+
+DueScheduler::TrackedDeck& DueScheduler::StartTracking(const SessionKey& key, uint cards)
+{
+    // -- every card of the deck is in the wheel until it comes due, so all of those go stale at once...
+    TrackedDeck& deck = _decks[key];
+    _stale += deck.dueAt.size() - deck.dueCount;
+
+    deck.dueAt.assign(cards, DueImmediately);
+    deck.due.assign(cards, false);
+    deck.dueCount = 0;
+    deck.generation = _nextGeneration++;
+
+    return deck;
+}
+
+void DueScheduler::Schedule(const SessionKey& key, TrackedDeck& deck, uint card, Timestamp dueAt)
+{
+    deck.dueAt[card] = dueAt;
+    _wheel.Schedule(DueCard{ key, card, dueAt, deck.generation });
+}
+
+void DueScheduler::Untrack(const SessionKey& key)
+{
+    auto found = _decks.find(key);
+
+    if (found == _decks.end())
+    {
+        return;
+    }
+
+    _stale += found->second.dueAt.size() - found->second.dueCount;
+    _decks.erase(found);
+
+    CompactIfStale();
+}
+
+// -- false for an entry of an untracked deck, an older tracking of it, or a card since rescheduled or handed out...
+bool DueScheduler::IsLive(const DueCard& card) const
+{
+    auto found = _decks.find(card.key);
+
+    if (found == _decks.end())
+    {
+        return false;
+    }
+
+    const TrackedDeck& deck = found->second;
+
+    return card.generation == deck.generation && card.card < deck.dueAt.size() &&
+        deck.dueAt[card.card] == card.dueAt && !deck.due[card.card];
+}
+
+// -- sweeping costs a pass over the whole wheel, so it waits until at least half of it is stale...
+void DueScheduler::CompactIfStale()
+{
+    if (_stale > Scheduled())
+    {
+        _stale -= _wheel.Remove([this](const DueCard& card) { return !IsLive(card); });
+    }
+}
+
+// -- a card was answered, so it stops counting as due until its new time comes...
+void DueScheduler::Reschedule(const SessionKey& key, uint card, Timestamp dueAt)
+{
+    auto found = _decks.find(key);
+
+    if (found == _decks.end())
+    {
+        return;
+    }
+
+    TrackedDeck& deck = found->second;
+
+    if (card >= deck.dueAt.size())
+    {
+        deck.dueAt.resize(card + 1, DueImmediately);
+        deck.due.resize(card + 1, false);
+    }
+    else if (deck.due[card])
+    {
+        deck.due[card] = false;
+        deck.dueCount--;
+    }
+    else if (deck.dueAt[card] == dueAt)
+    {
+        // -- its entry is still in the wheel and still right...
+        return;
+    }
+    else
+    {
+        _stale++;
+    }
+
+    Schedule(key, deck, card, dueAt);
+    CompactIfStale();
+}
+
+void DueScheduler::Advance(Timestamp now, const CardDue& due)
+{
+    _wheel.Advance(now, [this, &due](const DueCard& card)
+    {
+        // -- rescheduled, retracked or untracked since this entry went in...
+        if (!IsLive(card))
+        {
+            _stale--;
+            return;
+        }
+
+        TrackedDeck& deck = _decks.find(card.key)->second;
+        deck.due[card.card] = true;
+        deck.dueCount++;
+
+        if (due)
+        {
+            due(card.key, card.card, deck.dueCount);
+        }
+    });
+}
+
+uint DueScheduler::DueCount(const SessionKey& key) const
+{
+    auto found = _decks.find(key);
+
+    return (found != _decks.end()) ? found->second.dueCount : 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace jlimdev
+{
+    // -- one card of one learner's deck, waiting for its due time...
+    struct DueCard
+    {
+        SessionKey key;
+        uint card;
+        Timestamp dueAt;
+        // -- which tracking of the deck scheduled it, so entries from before a retrack can be told apart...
+        uint generation;
+    };
+
+    /// <summary>
+    /// Hierarchical timing wheel of due cards: four levels of 64 slots, each slot of a level spanning a whole turn
+    /// of the level below. A card goes into the coarsest slot it can, and is cascaded down a level each time that
+    /// slot comes around, so it is touched at most once per level however far off it is due. Due times are
+    /// rounded up to whole ticks, so a card is never handed out before its time and at most a tick after it.
+    /// </summary>
+    class DueTimingWheel
+    {
+    public:
+        static constexpr uint SlotBits = 6;
+        static constexpr uint Slots = 1U << SlotBits;
+        static constexpr uint Levels = 4;
+
+    private:
+        Timestamp _tickSeconds;
+        uint64_t _currentTick;
+        size_t _size;
+
+        std::vector<DueCard> _slots[Levels][Slots];
+        // -- cards already due when scheduled, and ones beyond the top level's reach...
+        std::vector<DueCard> _ready;
+        std::vector<DueCard> _overflow;
+
+    public:
+        DueTimingWheel(Timestamp now, Timestamp tickSeconds);
+
+        void Schedule(const DueCard& card);
+        void Advance(Timestamp now, const std::function<void(const DueCard& card)>& due);
+        size_t Remove(const std::function<bool(const DueCard& card)>& remove);
+
+        size_t Size() const noexcept { return _size; }
+        Timestamp TickSeconds() const noexcept { return _tickSeconds; }
+    private:
+        uint64_t TickOf(Timestamp dueAt) const noexcept;
+        void Place(const DueCard& card);
+        void Cascade();
+        void Fire(std::vector<DueCard>& slot, const std::function<void(const DueCard& card)>& due);
+    };
+
+    /// <summary>
+    /// Which of many learners' decks have cards due, without polling their sessions. Decks are tracked with the due
+    /// time of every card, answers reschedule a card, and Advance hands over each card as its wheel slot arrives,
+    /// along with how many cards of its deck are now due, so a count going from 0 to 1 is a deck that just came due.
+    /// Sessions don't know about the scheduler: whoever calls UpdateCard passes the due time it returns on to
+    /// Reschedule, or the card is handed out again at its old time. Entries left behind by rescheduling and
+    /// retracking are counted, and swept out of the wheel once they outnumber the live ones. Not thread-safe.
+    /// </summary>
+    class DueScheduler
+    {
+    public:
+        // -- a card has come due; dueCount is how many of its deck are due now, counting this one...
+        using CardDue = std::function<void(const SessionKey& key, uint card, uint dueCount)>;
+
+    private:
+        struct TrackedDeck
+        {
+            std::vector<Timestamp> dueAt;
+            std::vector<bool> due;
+            uint dueCount;
+            uint generation;
+        };
+
+        DueTimingWheel _wheel;
+        std::unordered_map<SessionKey, TrackedDeck, SessionKeyHash> _decks;
+        uint _nextGeneration;
+        // -- entries still in the wheel that will be dropped when they come around...
+        size_t _stale;
+
+    public:
+        explicit DueScheduler(Timestamp now, Timestamp tickSeconds = 60);
+
+        // -- start (or start over) tracking a deck, with every card's due time taken from its session...
+        template <typename Session>
+        void Track(const SessionKey& key, const Session& session)
+        {
+            TrackedDeck& deck = StartTracking(key, session.Size());
+
+            for (uint i = 0; i < session.Size(); i++)
+            {
+                Schedule(key, deck, i, session.GetNextReviewTime(i, DueImmediately));
+            }
+
+            CompactIfStale();
+        }
+
+        void Untrack(const SessionKey& key);
+        void Reschedule(const SessionKey& key, uint card, Timestamp dueAt);
+        void Advance(Timestamp now, const CardDue& due);
+
+        bool IsTracked(const SessionKey& key) const { return _decks.count(key) != 0; }
+        uint DueCount(const SessionKey& key) const;
+        size_t Size() const noexcept { return _decks.size(); }
+        size_t Scheduled() const noexcept { return _wheel.Size() - _stale; }
+        size_t Stale() const noexcept { return _stale; }
+    private:
+        TrackedDeck& StartTracking(const SessionKey& key, uint cards);
+        void Schedule(const SessionKey& key, TrackedDeck& deck, uint card, Timestamp dueAt);
+        bool IsLive(const DueCard& card) const;
+        void CompactIfStale();
+    };
+}
@@ -0,0 +1,172 @@
+#include "Dejavu.h"
+
+using namespace jlimdev;
+
+template <typename Strategy>
+BasicMultiDeckSession<Strategy>::BasicMultiDeckSession(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit,
+    std::pmr::memory_resource* upstream)
+    : _reviewStrategy(&reviewStrategy), _upstream(upstream), _newCardsReturned(0), _existingCardsReturned(0),
+      _newCardMax(maxNewCard), _existingCardMax(maxExistingCard), _cardLimit(cardLimit), _order(ReviewOrder::RoundRobin), _nextDeck(0)
+{
+}
+
+// -- an empty deck for the page to fill, e.g. with ImportRecords; null if a deck with that id is already in the session...
+template <typename Strategy>
+typename BasicMultiDeckSession<Strategy>::Session* BasicMultiDeckSession<Strategy>::AddDeck(uint deck, uint maxNewCard, uint maxExistingCard)
+{
+    if (_deckIndex.count(deck) != 0)
+    {
+        return nullptr;
+    }
+
+    auto session = std::make_unique<Session>(*_reviewStrategy, 0, 0, _cardLimit, _upstream);
+    Session* const added = session.get();
+    added->SetReviewOrder(_order);
+
+    _deckIndex.emplace(deck, _decks.size());
+    _decks.push_back(Deck{ deck, std::move(session), maxNewCard, maxExistingCard });
+
+    return added;
+}
+
+// -- cards the deck already handed out stay counted against the shared caps, the learner did spend the time on them...
+template <typename Strategy>
+bool BasicMultiDeckSession<Strategy>::RemoveDeck(uint deck)
+{
+    auto found = _deckIndex.find(deck);
+
+    if (found == _deckIndex.end())
+    {
+        return false;
+    }
+
+    const size_t removed = found->second;
+
+    _deckIndex.erase(found);
+    _decks.erase(_decks.begin() + removed);
+
+    for (size_t d = removed; d < _decks.size(); d++)
+    {
+        _deckIndex[_decks[d].id] = d;
+    }
+
+    // -- keep the turn with the deck that would have been next...
+    if (_nextDeck > removed)
+    {
+        _nextDeck--;
+    }
+
+    if (_nextDeck >= _decks.size())
+    {
+        _nextDeck = 0;
+    }
+
+    return true;
+}
+
+template <typename Strategy>
+typename BasicMultiDeckSession<Strategy>::Session* BasicMultiDeckSession<Strategy>::FindDeck(uint deck)
+{
+    auto found = _deckIndex.find(deck);
+
+    return (found != _deckIndex.end()) ? _decks[found->second].session.get() : nullptr;
+}
+
+template <typename Strategy>
+void BasicMultiDeckSession<Strategy>::SetDeckCaps(uint deck, uint maxNewCard, uint maxExistingCard)
+{
+    auto found = _deckIndex.find(deck);
+
+    if (found != _deckIndex.end())
+    {
+        _decks[found->second].newCardMax = maxNewCard;
+        _decks[found->second].existingCardMax = maxExistingCard;
+    }
+}
+
+// -- each deck in turn, starting after the one that gave the last card, gets to hand out its next card.
+// -- before it is asked, its caps are narrowed to whatever is left of the shared ones, so it can't overspend them...
+template <typename Strategy>
+std::optional<DeckCard> BasicMultiDeckSession<Strategy>::NextReview(Timestamp now)
+{
+    for (size_t n = 0; n < _decks.size(); n++)
+    {
+        const size_t d = (_nextDeck + n) % _decks.size();
+        Deck& deck = _decks[d];
+        Session& session = *deck.session;
+
+        const uint newReturned = session.NewCardsReturned();
+        const uint existingReturned = session.ExistingCardsReturned();
+
+        session.SetCardCaps(
+            std::min(deck.newCardMax, newReturned + (_newCardMax - _newCardsReturned)),
+            std::min(deck.existingCardMax, existingReturned + (_existingCardMax - _existingCardsReturned)));
+
+        const std::optional<uint> next = session.NextReview(now);
+
+        if (next)
+        {
+            _newCardsReturned += session.NewCardsReturned() - newReturned;
+            _existingCardsReturned += session.ExistingCardsReturned() - existingReturned;
+            _nextDeck = (d + 1) % _decks.size();
+
+            return DeckCard{ deck.id, *next };
+        }
+    }
+
+    return std::nullopt;
+}
+
+// -- the card's next review time, or nothing if its deck has been removed, or the answer doesn't fit the deck's dates
+// -- or couldn't be logged...
+template <typename Strategy>
+std::optional<Timestamp> BasicMultiDeckSession<Strategy>::UpdateCard(const DeckCard& card, const ReviewOutcome& outcome, Timestamp now)
+{
+    Session* session = FindDeck(card.deck);
+
+    if (session == nullptr || card.card >= session->Size())
+    {
+        return std::nullopt;
+    }
+
+    return session->UpdateCard(card.card, outcome, now);
+}
+
+template <typename Strategy>
+void BasicMultiDeckSession<Strategy>::SetReviewOrder(ReviewOrder order)
+{
+    _order = order;
+
+    for (Deck& deck : _decks)
+    {
+        deck.session->SetReviewOrder(order);
+    }
+}
+
+// -- every deck dropped and the caps counted from zero again...
+template <typename Strategy>
+void BasicMultiDeckSession<Strategy>::Reset()
+{
+    _decks.clear();
+    _deckIndex.clear();
+    _nextDeck = 0;
+    _newCardsReturned = 0;
+    _existingCardsReturned = 0;
+}
+
+template <typename Strategy>
+uint BasicMultiDeckSession<Strategy>::Size() const noexcept
+{
+    uint size = 0;
+
+    for (const Deck& deck : _decks)
+    {
+        size += deck.session->Size();
+    }
+
+    return size;
+}
+
+// -- the polymorphic session used by the tests, and the SM-2 one the app runs on...
+template class jlimdev::BasicMultiDeckSession<IReviewStrategy>;
+template class jlimdev::BasicMultiDeckSession<SuperMemo2ReviewStrategy>;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace jlimdev
+{
+    // -- a card of one of the decks in a multi-deck session...
+    struct DeckCard
+    {
+        uint deck;
+        uint card;
+    };
+
+    /// <summary>
+    /// One learner studying several decks at once. Each deck keeps a study session and card store of its own,
+    /// so decks come and go without touching the others, while the new and existing card caps are shared by
+    /// the whole session. A deck can also be given caps of its own, to split the shared ones between decks.
+    /// Picks go round the decks in turn, each deck handing out its next card in its own order.
+    /// </summary>
+    template <typename Strategy>
+    class BasicMultiDeckSession
+    {
+    public:
+        using Session = BasicStudySession<Strategy>;
+
+    private:
+        struct Deck
+        {
+            uint id;
+            std::unique_ptr<Session> session;
+            uint newCardMax;
+            uint existingCardMax;
+        };
+
+        const Strategy* _reviewStrategy;
+        std::pmr::memory_resource* _upstream;
+
+        uint _newCardsReturned;
+        uint _existingCardsReturned;
+        uint _newCardMax;
+        uint _existingCardMax;
+        uint _cardLimit;
+        ReviewOrder _order;
+
+        std::vector<Deck> _decks;
+        std::unordered_map<uint, size_t> _deckIndex;
+        // -- the deck to try first on the next pick...
+        size_t _nextDeck;
+
+    public:
+        BasicMultiDeckSession(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+        BasicMultiDeckSession(const BasicMultiDeckSession&) = delete;
+        BasicMultiDeckSession& operator=(const BasicMultiDeckSession&) = delete;
+
+        Session* AddDeck(uint deck, uint maxNewCard = UINT32_MAX, uint maxExistingCard = UINT32_MAX);
+        bool RemoveDeck(uint deck);
+        Session* FindDeck(uint deck);
+        void SetDeckCaps(uint deck, uint maxNewCard, uint maxExistingCard);
+
+        std::optional<DeckCard> NextReview(Timestamp now);
+        std::optional<Timestamp> UpdateCard(const DeckCard& card, const ReviewOutcome& outcome, Timestamp now);
+        void SetReviewOrder(ReviewOrder order);
+        void Reset();
+
+        size_t DeckCount() const noexcept { return _decks.size(); }
+        uint Size() const noexcept;
+        uint NewCardsReturned() const noexcept { return _newCardsReturned; }
+        uint ExistingCardsReturned() const noexcept { return _existingCardsReturned; }
+    };
+
+    // -- both are explicitly instantiated in MultiDeckSession.cpp...
+    extern template class BasicMultiDeckSession<IReviewStrategy>;
+    extern template class BasicMultiDeckSession<SuperMemo2ReviewStrategy>;
+
+    using MultiDeckSession = BasicMultiDeckSession<IReviewStrategy>;
+    using SuperMemo2MultiDeckSession = BasicMultiDeckSession<SuperMemo2ReviewStrategy>;
+}
@@ -0,0 +1,97 @@
+#include "Dejavu.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace jlimdev;
+
+// -- same schedule as NextReviewSuperMemo2Visitor, with the easiness factor and first interval from the strategy...
+struct NextReviewParameterizedVisitor
+{
+    const ParameterizedSuperMemo2ReviewStrategy& strategy;
+    Timestamp firstInterval;
+    Timestamp now;
+
+    Timestamp operator()(const NeverReviewed& nr)
+    {
+        return now;
+    }
+    Timestamp operator()(const PreviouslyIncorrect& p)
+    {
+        return now;
+    }
+    Timestamp operator()(const PreviouslyFirstCorrect& p)
+    {
+        return p.reviewDate + firstInterval;
+    }
+    Timestamp operator()(const PreviouslyCorrect& p)
+    {
+        const double easinessFactor = strategy.EasinessFactor(p.difficultyRating);
+        const uint seconds = static_cast<uint>(p.reviewDate - p.previousCorrectReview);
+        const uint daysSincePreviousReview = seconds / (24 * 60 * 60);
+        const uint daysUntilNextReview = static_cast<int>((daysSincePreviousReview - 1) * easinessFactor);
+
+        return p.reviewDate + daysUntilNextReview * 24U * 60 * 60;
+    }
+};
+
+ParameterizedSuperMemo2ReviewStrategy::ParameterizedSuperMemo2ReviewStrategy(const SuperMemo2Parameters& parameters) noexcept
+    : _parameters(parameters),
+      _firstInterval(static_cast<Timestamp>(std::lround(std::max(parameters.firstIntervalDays, 0.0) * 24 * 60 * 60)))
+{
+    for (uint rating = 0; rating <= DifficultyRatingMostDifficult; rating++)
+    {
+        // using a linear equation - y = mx + b
+        _easinessFactor[rating] = (_parameters.easinessSlope * rating) + _parameters.easinessIntercept;
+
+        for (uint outcome = 0; outcome < 4; outcome++)
+        {
+            _adjustDifficulty[rating * 4 + outcome] = static_cast<uint8_t>(
+                AdjustDifficultyRating(_parameters, rating, static_cast<ReviewOutcome>(outcome)));
+        }
+    }
+}
+
+Timestamp ParameterizedSuperMemo2ReviewStrategy::NextReview(const ReviewItem& item, const Timestamp& now) const noexcept
+{
+    return std::visit(NextReviewParameterizedVisitor{ *this, _firstInterval, now }, item);
+}
+
+DifficultyRating ParameterizedSuperMemo2ReviewStrategy::AdjustDifficulty(const ReviewItem& item, const ReviewOutcome& reviewOutcome) const noexcept
+{
+    const DifficultyRating rating = std::visit(
+        [](auto&& item) -> DifficultyRating { return item.difficultyRating; },
+        item);
+    const DifficultyRating clampedRating = std::min(rating, DifficultyRatingMostDifficult);
+
+    return _adjustDifficulty[clampedRating * 4 + static_cast<uint>(reviewOutcome)];
+}
+
+double ParameterizedSuperMemo2ReviewStrategy::EasinessFactor(DifficultyRating difficultyRating) const noexcept
+{
+    return _easinessFactor[std::min(difficultyRating, DifficultyRatingMostDifficult)];
+}
+
+// -- SuperMemo2ReviewStrategy::AdjustDifficultyRating with the constants swapped for parameters, term for term,
+// -- so the default parameters round to the very same ratings...
+DifficultyRating ParameterizedSuperMemo2ReviewStrategy::AdjustDifficultyRating(const SuperMemo2Parameters& parameters,
+    DifficultyRating rating, ReviewOutcome reviewOutcome) noexcept
+{
+    // -- q on the 0-3 scale: Perfect 3, Hesitant 2, Incorrect 1, NeverReviewed 0...
+    const double outcome = 3.0 - static_cast<double>(static_cast<uint>(reviewOutcome));
+    const double currentEasinessFactor = (parameters.easinessSlope * rating) + parameters.easinessIntercept;
+    const double newEasinessFactor = currentEasinessFactor +
+        (parameters.updateBase - (3 - outcome) * (parameters.updateLinear + (3 - outcome) * parameters.updateQuadratic));
+    // using a linear equation - x = (y - b)/m
+    double newDifficultyRating = (newEasinessFactor - parameters.easinessIntercept) / parameters.easinessSlope;
+
+    if (!(newDifficultyRating <= 100))
+    {
+        newDifficultyRating = 100;
+    }
+    if (newDifficultyRating < 0)
+    {
+        newDifficultyRating = 0;
+    }
+
+    return static_cast<DifficultyRating>(newDifficultyRating);
+}
@@ -1,13 +1,22 @@
 #pragma once
 
+#include <cstdint>
 #include <variant>
 
 namespace jlimdev
 {
     using uint = unsigned int;
-    using Timestamp = uint;
+    // -- seconds since the unix epoch...
+    using Timestamp = uint64_t;
+    // -- seconds since a deck's own epoch, which is how CardStore keeps per-card dates at half the width...
+    using DeckTime = uint32_t;
     using DifficultyRating = uint;
 
+    constexpr DeckTime DeckTimeMax = UINT32_MAX;
+
+    // -- strategies answer "now" for cards that are always due, so that is what the epoch means in a due time...
+    constexpr Timestamp DueImmediately = 0U;
+
     constexpr DifficultyRating DifficultyRatingEasiest = 0U;
     constexpr DifficultyRating DifficultyRatingMostDifficult = 100U;
 
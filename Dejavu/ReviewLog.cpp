@@ -0,0 +1,122 @@
+#include "Dejavu.h"
+#include <cstring>
+
+using namespace jlimdev;
+
+// -- swap the file for one holding just the events in memory, then carry on appending to that.
+// -- the new file replaces the old in one rename, so a crash part way leaves the old one whole...
+bool ReviewLog::Rewrite()
+{
+    const uint32_t header[3] = { ReviewLogMagic, ReviewLogVersion, _firstSequence };
+    std::vector<uint8_t> image(sizeof(header) + _events.size() * sizeof(ReviewEvent));
+
+    std::memcpy(image.data(), header, sizeof(header));
+
+    if (!_events.empty())
+    {
+        std::memcpy(image.data() + sizeof(header), _events.data(), _events.size() * sizeof(ReviewEvent));
+    }
+
+    if (_file.is_open())
+    {
+        _file.close();
+    }
+
+    _file.clear();
+
+    const bool replaced = WriteFileAtomically(_path.c_str(), image.data(), image.size());
+
+    // -- if it wasn't, answers keep going to the old file, which is still whole...
+    _file.open(_path, std::ios::binary | std::ios::app);
+
+    return replaced && _file.is_open() && !_file.fail();
+}
+
+// -- read back what an earlier run logged, then keep appending to the same file...
+bool ReviewLog::Open(const char* path)
+{
+    Close();
+    _events.clear();
+    _firstSequence = 0;
+    _path = path;
+
+    std::ifstream existing(path, std::ios::binary);
+    uint32_t header[3] = { 0, 0, 0 };
+
+    if (existing && existing.read(reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        if (header[0] != ReviewLogMagic || header[1] != ReviewLogVersion)
+        {
+            return false;
+        }
+
+        _firstSequence = header[2];
+
+        ReviewEvent event;
+
+        while (existing.read(reinterpret_cast<char*>(&event), sizeof(event)))
+        {
+            _events.push_back(event);
+        }
+
+        existing.close();
+
+        // -- rewrite without the torn tail, if there was one, so new records stay aligned...
+        if (existing.gcount() != 0)
+        {
+            return Rewrite();
+        }
+
+        _file.open(path, std::ios::binary | std::ios::app);
+
+        return _file.is_open() && !_file.fail();
+    }
+
+    existing.close();
+
+    return Rewrite();
+}
+
+void ReviewLog::Close()
+{
+    if (_file.is_open())
+    {
+        _file.close();
+    }
+
+    _file.clear();
+    _path.clear();
+}
+
+// -- sixteen bytes per answer, flushed straight away so a crash loses at most the answer being written...
+// -- false, with nothing recorded, if the file didn't take it. the stream stays failed until the next Open or Truncate
+// -- rewrites the file, so whatever part of the record got written is a torn tail that opening drops.
+bool ReviewLog::Append(uint card, ReviewOutcome outcome, Timestamp reviewedAt)
+{
+    const ReviewEvent event{ reviewedAt, card, static_cast<uint8_t>(outcome), { 0, 0, 0 } };
+
+    if (_file.is_open())
+    {
+        _file.write(reinterpret_cast<const char*>(&event), sizeof(event));
+        _file.flush();
+
+        if (!_file)
+        {
+            return false;
+        }
+    }
+
+    _events.push_back(event);
+
+    return true;
+}
+
+// -- everything before firstSequence is in a snapshot now, start the history afresh from there...
+// -- false if the file couldn't be replaced, in which case it still holds the old history, which replay skips past.
+bool ReviewLog::Truncate(uint firstSequence)
+{
+    _events.clear();
+    _firstSequence = firstSequence;
+
+    return !_file.is_open() || Rewrite();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace jlimdev
+{
+    constexpr uint32_t ReviewLogMagic = 0x4c564a44U; // "DJVL" read as little-endian bytes
+    constexpr uint32_t ReviewLogVersion = 1U;
+
+    /// <summary>
+    /// One answer, as it was given to UpdateCard. A 64-bit review time, then two 32-bit words:
+    /// card index and the outcome in the low byte.
+    /// </summary>
+    struct ReviewEvent
+    {
+        Timestamp reviewedAt;
+        uint card;
+        uint8_t outcome;
+        uint8_t reserved[3];
+    };
+
+    static_assert(sizeof(ReviewEvent) == 16);
+
+    /// <summary>
+    /// Append-only history of answers since the last compaction. Kept in memory, and when opened on a file
+    /// every answer is also appended there as it happens: a 12 byte header (magic, version, first sequence) then ReviewEvents.
+    /// The first sequence numbers the log's first event in the session's count of answers, so replay can skip
+    /// what a snapshot already holds. A torn record at the end of the file, from a crash mid-write, is dropped on open.
+    /// Rewrites go to a temporary file that is renamed over the log, see WriteFileAtomically.
+    /// </summary>
+    class ReviewLog
+    {
+    private:
+        std::vector<ReviewEvent> _events;
+        uint _firstSequence = 0;
+        std::string _path;
+        std::ofstream _file;
+
+        bool Rewrite();
+
+    public:
+        bool Open(const char* path);
+        void Close();
+
+        bool Append(uint card, ReviewOutcome outcome, Timestamp reviewedAt);
+        bool Truncate(uint firstSequence);
+
+        const std::vector<ReviewEvent>& Events() const noexcept { return _events; }
+        size_t Size() const noexcept { return _events.size(); }
+        uint FirstSequence() const noexcept { return _firstSequence; }
+    };
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 namespace jlimdev
 {
     enum class ReviewOutcome
@@ -16,6 +20,41 @@ namespace jlimdev
         virtual ~IReviewStrategy() { };
         virtual Timestamp NextReview(const ReviewItem& item, const Timestamp& now) const = 0;
         virtual DifficultyRating AdjustDifficulty(const ReviewItem& item, const ReviewOutcome& outcome) const = 0;
+
+        // -- schedule a whole run of cards in one call, out must have room for count timestamps...
+        virtual void NextReviewBatch(const ReviewItem* items, size_t count, const Timestamp& now, Timestamp* out) const
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                out[i] = NextReview(items[i], now);
+            }
+        }
+
+        // -- schedule count cards of a store starting at first, reading straight from its columns...
+        // -- now and out are in the store's deck time, this default goes through whole timestamps and back.
+        virtual void NextReviewColumns(const CardStore& cards, uint first, uint count, const DeckTime& now, DeckTime* out) const
+        {
+            constexpr uint chunkSize = 256;
+            ReviewItem chunk[chunkSize];
+            Timestamp nextReview[chunkSize];
+
+            for (uint start = 0; start < count; start += chunkSize)
+            {
+                const uint chunkCount = (count - start < chunkSize) ? count - start : chunkSize;
+
+                for (uint j = 0; j < chunkCount; j++)
+                {
+                    chunk[j] = cards.At(first + start + j);
+                }
+
+                NextReviewBatch(chunk, chunkCount, cards.FromDeckTime(now), nextReview);
+
+                for (uint j = 0; j < chunkCount; j++)
+                {
+                    out[start + j] = cards.ToDeckTime(nextReview[j]);
+                }
+            }
+        }
     };
 
     class SimpleReviewStrategy : public IReviewStrategy
@@ -43,10 +82,11 @@ namespace jlimdev
     /// <summary>
     /// Implementation of the SuperMemo2 algorithm described here: http://www.supermemo.com/english/ol/sm2.htm
     /// </summary>
-    class SuperMemo2ReviewStrategy : public IReviewStrategy
+    class SuperMemo2ReviewStrategy final : public IReviewStrategy
     {
     public:
         // -- rule of 5, since derived class remember to make destructor virtual..
+        // -- final, so a session holding this type calls it without going through the vtable..
         SuperMemo2ReviewStrategy() noexcept {}
         SuperMemo2ReviewStrategy(const SuperMemo2ReviewStrategy& s) = default;
         SuperMemo2ReviewStrategy(SuperMemo2ReviewStrategy&& s) = default;
@@ -56,13 +96,135 @@ namespace jlimdev
 
         Timestamp NextReview(const ReviewItem& item, const Timestamp& now) const noexcept override;
 
+        void NextReviewBatch(const ReviewItem* items, size_t count, const Timestamp& now, Timestamp* out) const noexcept override;
+
+        void NextReviewColumns(const CardStore& cards, uint first, uint count, const DeckTime& now, DeckTime* out) const override;
+
         DifficultyRating AdjustDifficulty(const ReviewItem& item, const ReviewOutcome& reviewOutcome) const noexcept override;
 
-        static double DifficultyRatingToEasinessFactor(uint difficultyRating) noexcept;
+        static constexpr double DifficultyRatingToEasinessFactor(uint difficultyRating) noexcept
+        {
+            // using a linear equation - y = mx + b
+            return (-0.012 * difficultyRating) + 2.5;
+        }
+
+        // -- the SM-2 update itself, AdjustDifficulty answers from a table generated from this...
+        static constexpr DifficultyRating AdjustDifficultyRating(DifficultyRating rating, ReviewOutcome reviewOutcome) noexcept
+        {
+            //EF':=EF+(0.1-(3-q)*(0.08+(3-q)*0.02))
+            //where:
+            //EF' - new value of the E-Factor,
+            //EF - old value of the E-Factor,
+            //q - quality of the response in the 0-3 grade scale.
+            //If EF is less than 1.3 then let EF be 1.3.
+            const double outcome = ConvertOutcomeToNumber(reviewOutcome);
+            const double currentEasinessFactor = DifficultyRatingToEasinessFactor(rating);
+            const double newEasinessFactor = currentEasinessFactor + (0.1 - (3 - outcome) * (0.08 + (3 - outcome) * 0.02));
+            double newDifficultyRating = EasinessFactorToDifficultyRating(newEasinessFactor);
+
+            if (newDifficultyRating > 100)
+            {
+                newDifficultyRating = 100;
+            }
+            if (newDifficultyRating < 0)
+            {
+                newDifficultyRating = 0;
+            }
+
+            return static_cast<DifficultyRating>(newDifficultyRating);
+        }
+
+        // -- vectorized schedule for contiguous PreviouslyCorrect cards in deck time, matches NextReview exactly
+        // -- in the low 32 bits, which is all of it for any deck that fits in deck time...
+        static void NextReviewPreviouslyCorrect(const uint8_t* difficultyRating, const DeckTime* reviewDate,
+            const DeckTime* previousCorrectReview, size_t count, DeckTime* out) noexcept;
+
+    private:
+        // convert enum class to number for formula
+        static constexpr double ConvertOutcomeToNumber(const ReviewOutcome& reviewOutcome) noexcept
+        {
+            double outcome = 0.0;
+
+            switch (reviewOutcome)
+            {
+            case ReviewOutcome::Perfect:
+            {
+                outcome = 3.0;
+                break;
+            }
+            case ReviewOutcome::Hesitant:
+            {
+                outcome = 2.0;
+                break;
+            }
+            case ReviewOutcome::Incorrect:
+            {
+                outcome = 1.0;
+                break;
+            }
+            case ReviewOutcome::NeverReviewed:
+            {
+                outcome = 0.0;
+                break;
+            }
+            }
+
+            return outcome;
+        }
+
+        static constexpr double EasinessFactorToDifficultyRating(double easinessFactor) noexcept
+        {
+            // using a linear equation - x = (y - b)/m
+            return (easinessFactor - 2.5) / -0.012;
+        }
+    };
 
+    /// <summary>
+    /// The constants SM-2 is built from, so they can be fitted to real answers. The defaults are the ones
+    /// SuperMemo2ReviewStrategy hard-codes.
+    /// </summary>
+    struct SuperMemo2Parameters
+    {
+        // -- easiness factor = easinessIntercept + easinessSlope * difficulty rating...
+        double easinessIntercept = 2.5;
+        double easinessSlope = -0.012;
+        // -- EF' = EF + (updateBase - (3 - q) * (updateLinear + (3 - q) * updateQuadratic))...
+        double updateBase = 0.1;
+        double updateLinear = 0.08;
+        double updateQuadratic = 0.02;
+        // -- wait after the first correct answer...
+        double firstIntervalDays = 6.0;
+    };
+
+    /// <summary>
+    /// SM-2 with its constants taken from SuperMemo2Parameters instead of compiled in. Tables are built once
+    /// from the parameters, so scheduling costs the same lookups as SuperMemo2ReviewStrategy,
+    /// and with the default parameters it schedules exactly the same.
+    /// </summary>
+    class ParameterizedSuperMemo2ReviewStrategy final : public IReviewStrategy
+    {
     private:
-        static double ConvertOutcomeToNumber(const ReviewOutcome& reviewOutcome) noexcept;
+        SuperMemo2Parameters _parameters;
+        Timestamp _firstInterval;
+        std::array<double, DifficultyRatingMostDifficult + 1> _easinessFactor;
+        std::array<uint8_t, (DifficultyRatingMostDifficult + 1) * 4> _adjustDifficulty;
+
+    public:
+        explicit ParameterizedSuperMemo2ReviewStrategy(const SuperMemo2Parameters& parameters = SuperMemo2Parameters()) noexcept;
+        ParameterizedSuperMemo2ReviewStrategy(const ParameterizedSuperMemo2ReviewStrategy& s) = default;
+        ParameterizedSuperMemo2ReviewStrategy(ParameterizedSuperMemo2ReviewStrategy&& s) = default;
+        ParameterizedSuperMemo2ReviewStrategy& operator=(const ParameterizedSuperMemo2ReviewStrategy& s) = default;
+        ParameterizedSuperMemo2ReviewStrategy& operator=(ParameterizedSuperMemo2ReviewStrategy&& s) = default;
+        ~ParameterizedSuperMemo2ReviewStrategy() = default;
+
+        Timestamp NextReview(const ReviewItem& item, const Timestamp& now) const noexcept override;
+
+        DifficultyRating AdjustDifficulty(const ReviewItem& item, const ReviewOutcome& reviewOutcome) const noexcept override;
+
+        const SuperMemo2Parameters& Parameters() const noexcept { return _parameters; }
+        double EasinessFactor(DifficultyRating difficultyRating) const noexcept;
 
-        static double EasinessFactorToDifficultyRating(double easinessFactor) noexcept;
+        // -- the SM-2 update with these parameters, AdjustDifficulty answers from a table generated from this...
+        static DifficultyRating AdjustDifficultyRating(const SuperMemo2Parameters& parameters, DifficultyRating rating, ReviewOutcome reviewOutcome) noexcept;
     };
 }
\ No newline at end of file
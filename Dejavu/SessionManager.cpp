@@ -0,0 +1,256 @@
+#include "Dejavu.h"
+
+using namespace jlimdev;
+
+template <typename Strategy>
+BasicSessionManager<Strategy>::BasicSessionManager(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit,
+    size_t memoryBudget, LoadSession load, SaveSession save)
+    : _reviewStrategy(&reviewStrategy), _newCardMax(maxNewCard), _existingCardMax(maxExistingCard), _cardLimit(cardLimit),
+      _memoryBudget(memoryBudget), _memoryUsage(0), _leavingUsage(0), _load(std::move(load)), _save(std::move(save))
+{
+}
+
+template <typename Strategy>
+BasicSessionManager<Strategy>::~BasicSessionManager()
+{
+    while (!_recent.empty())
+    {
+        Drop(std::prev(_recent.end()));
+    }
+}
+
+// -- the learner's session, loading it if it isn't already, or null if the loader has no such deck...
+// -- the pointer stays good until the session is evicted, which only another Acquire or Evict can do.
+template <typename Strategy>
+typename BasicSessionManager<Strategy>::Session* BasicSessionManager<Strategy>::Acquire(const SessionKey& key)
+{
+    // -- whatever was used last has likely grown or shrunk since it was measured, pinned ones are measured on release...
+    if (!_recent.empty() && _recent.front().pins == 0)
+    {
+        Refresh(_recent.front());
+    }
+
+    auto found = _sessions.find(key);
+
+    if (found != _sessions.end())
+    {
+        _recent.splice(_recent.begin(), _recent, found->second);
+    }
+    else
+    {
+        auto session = std::make_unique<Session>(*_reviewStrategy, _newCardMax, _existingCardMax, _cardLimit);
+
+        if (!_load || !_load(key, *session))
+        {
+            return nullptr;
+        }
+
+        _recent.push_front(LoadedSession{ key, std::move(session), 0, 0, 0 });
+        _sessions.emplace(key, _recent.begin());
+        Refresh(_recent.front());
+    }
+
+    EvictOverBudget();
+
+    return _recent.front().session.get();
+}
+
+// -- Acquire, and keep the session loaded until it is released, however cold it gets...
+template <typename Strategy>
+typename BasicSessionManager<Strategy>::Session* BasicSessionManager<Strategy>::Pin(const SessionKey& key)
+{
+    Session* session = Acquire(key);
+
+    if (session != nullptr)
+    {
+        _recent.front().pins++;
+    }
+
+    return session;
+}
+
+template <typename Strategy>
+void BasicSessionManager<Strategy>::Release(const SessionKey& key)
+{
+    auto found = _sessions.find(key);
+
+    if (found == _sessions.end() || found->second->pins == 0)
+    {
+        return;
+    }
+
+    LoadedSession& loaded = *found->second;
+    loaded.pins--;
+    Refresh(loaded);
+
+    EvictOverBudget();
+}
+
+// -- for a caller that loads and saves outside its own lock, see ShardedSessionManager: the key's session, pinned,
+// -- or a fresh empty one for the caller to fill if it isn't loaded. nothing is loaded, saved or evicted here...
+template <typename Strategy>
+typename BasicSessionManager<Strategy>::Session* BasicSessionManager<Strategy>::Reserve(const SessionKey& key)
+{
+    auto found = _sessions.find(key);
+
+    if (found != _sessions.end())
+    {
+        _recent.splice(_recent.begin(), _recent, found->second);
+    }
+    else
+    {
+        auto session = std::make_unique<Session>(*_reviewStrategy, _newCardMax, _existingCardMax, _cardLimit);
+
+        _recent.push_front(LoadedSession{ key, std::move(session), 0, 0, 0 });
+        _sessions.emplace(key, _recent.begin());
+        Refresh(_recent.front());
+    }
+
+    _recent.front().pins++;
+
+    return _recent.front().session.get();
+}
+
+// -- pin the coldest sessions nobody has pinned until the rest fit the budget, for the caller to save and then
+// -- Unpin as leaving. same choice as EvictOverBudget, counting sessions already on their way out as gone...
+template <typename Strategy>
+void BasicSessionManager<Strategy>::PinOverBudget(std::vector<std::pair<SessionKey, Session*>>& leaving)
+{
+    size_t remaining = (_memoryUsage > _leavingUsage) ? _memoryUsage - _leavingUsage : 0;
+
+    for (auto it = _recent.end(); remaining > _memoryBudget && it != _recent.begin() && std::prev(it) != _recent.begin();)
+    {
+        --it;
+
+        if (it->pins != 0)
+        {
+            continue;
+        }
+
+        it->pins++;
+        it->leaving = it->memoryUsage;
+        _leavingUsage += it->memoryUsage;
+        remaining -= it->memoryUsage;
+        leaving.emplace_back(it->key, it->session.get());
+    }
+}
+
+// -- let go of a Reserve or PinOverBudget pin, measuring the session again. with drop set, and nobody else
+// -- holding a pin, the session is dropped without being saved; returns true if it was...
+template <typename Strategy>
+bool BasicSessionManager<Strategy>::Unpin(const SessionKey& key, bool leaving, bool drop)
+{
+    auto found = _sessions.find(key);
+
+    if (found == _sessions.end() || found->second->pins == 0)
+    {
+        return false;
+    }
+
+    LoadedSession& loaded = *found->second;
+
+    if (leaving)
+    {
+        _leavingUsage -= loaded.leaving;
+        loaded.leaving = 0;
+    }
+
+    loaded.pins--;
+    Refresh(loaded);
+
+    if (!drop || loaded.pins != 0)
+    {
+        return false;
+    }
+
+    _memoryUsage -= loaded.memoryUsage;
+    _recent.erase(found->second);
+    _sessions.erase(found);
+
+    return true;
+}
+
+template <typename Strategy>
+bool BasicSessionManager<Strategy>::Evict(const SessionKey& key)
+{
+    auto found = _sessions.find(key);
+
+    if (found == _sessions.end() || found->second->pins != 0)
+    {
+        return false;
+    }
+
+    Drop(found->second);
+
+    return true;
+}
+
+template <typename Strategy>
+void BasicSessionManager<Strategy>::EvictAll()
+{
+    for (auto it = _recent.begin(); it != _recent.end();)
+    {
+        auto next = std::next(it);
+
+        if (it->pins == 0)
+        {
+            Drop(it);
+        }
+
+        it = next;
+    }
+}
+
+template <typename Strategy>
+void BasicSessionManager<Strategy>::SetMemoryBudget(size_t memoryBudget)
+{
+    _memoryBudget = memoryBudget;
+
+    EvictOverBudget();
+}
+
+template <typename Strategy>
+void BasicSessionManager<Strategy>::Refresh(LoadedSession& loaded)
+{
+    _memoryUsage -= loaded.memoryUsage;
+    loaded.memoryUsage = loaded.session->MemoryUsage();
+    _memoryUsage += loaded.memoryUsage;
+}
+
+// -- coldest first, but never a pinned session or the one just handed out, even if it alone is over budget...
+template <typename Strategy>
+void BasicSessionManager<Strategy>::EvictOverBudget()
+{
+    auto it = _recent.end();
+
+    while (_memoryUsage > _memoryBudget && !_recent.empty() && std::prev(it) != _recent.begin())
+    {
+        const auto candidate = std::prev(it);
+
+        if (candidate->pins == 0)
+        {
+            Drop(candidate);
+        }
+        else
+        {
+            it = candidate;
+        }
+    }
+}
+
+template <typename Strategy>
+void BasicSessionManager<Strategy>::Drop(typename std::list<LoadedSession>::iterator it)
+{
+    if (_save)
+    {
+        _save(it->key, *it->session);
+    }
+
+    _memoryUsage -= it->memoryUsage;
+    _leavingUsage -= it->leaving;
+    _sessions.erase(it->key);
+    _recent.erase(it);
+}
+
+template class jlimdev::BasicSessionManager<IReviewStrategy>;
+template class jlimdev::BasicSessionManager<SuperMemo2ReviewStrategy>;
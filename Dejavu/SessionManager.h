@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace jlimdev
+{
+    // -- one learner studying one deck...
+    struct SessionKey
+    {
+        uint user;
+        uint deck;
+
+        bool operator==(const SessionKey& other) const noexcept { return user == other.user && deck == other.deck; }
+    };
+
+    // -- std::hash of an integer can be the integer itself, so mix the bits (splitmix64 finalizer)
+    // -- to keep every part of the key in the low bits that pick a bucket or a shard...
+    struct SessionKeyHash
+    {
+        size_t operator()(const SessionKey& key) const noexcept
+        {
+            uint64_t h = (static_cast<uint64_t>(key.user) << 32) | key.deck;
+
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+
+            return static_cast<size_t>(h ^ (h >> 31));
+        }
+    };
+
+    /// <summary>
+    /// Many learners' sessions in one process. A session is loaded the first time it is asked for and stays
+    /// until it is the least recently used one and the loaded sessions together are over the memory budget;
+    /// it is handed to the save callback on its way out so nothing answered is lost.
+    /// Sessions that are pinned are never evicted. Not thread-safe on its own, see ShardedSessionManager.
+    /// </summary>
+    template <typename Strategy>
+    class BasicSessionManager
+    {
+    public:
+        using Session = BasicStudySession<Strategy>;
+        // -- fill a fresh, empty session for the key, e.g. Restore from its snapshot and log; false if there is no such deck...
+        using LoadSession = std::function<bool(const SessionKey& key, Session& session)>;
+        // -- persist a session about to be dropped, e.g. ExportDirtyRecords or CompactReviewLog...
+        using SaveSession = std::function<void(const SessionKey& key, Session& session)>;
+
+    private:
+        struct LoadedSession
+        {
+            SessionKey key;
+            std::unique_ptr<Session> session;
+            size_t memoryUsage;
+            uint pins;
+            // -- what PinOverBudget counted as on its way out, zero unless the caller is saving it to drop it...
+            size_t leaving;
+        };
+
+        const Strategy* _reviewStrategy;
+        uint _newCardMax;
+        uint _existingCardMax;
+        uint _cardLimit;
+
+        size_t _memoryBudget;
+        size_t _memoryUsage;
+        size_t _leavingUsage;
+        LoadSession _load;
+        SaveSession _save;
+
+        // -- most recently used at the front, so eviction takes from the back...
+        std::list<LoadedSession> _recent;
+        std::unordered_map<SessionKey, typename std::list<LoadedSession>::iterator, SessionKeyHash> _sessions;
+
+    public:
+        BasicSessionManager(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit,
+            size_t memoryBudget, LoadSession load, SaveSession save);
+        BasicSessionManager(const BasicSessionManager& m) = delete;
+        BasicSessionManager& operator=(const BasicSessionManager& m) = delete;
+        ~BasicSessionManager();
+
+        Session* Acquire(const SessionKey& key);
+        Session* Pin(const SessionKey& key);
+        void Release(const SessionKey& key);
+        Session* Reserve(const SessionKey& key);
+        void PinOverBudget(std::vector<std::pair<SessionKey, Session*>>& leaving);
+        bool Unpin(const SessionKey& key, bool leaving, bool drop);
+        bool Evict(const SessionKey& key);
+        void EvictAll();
+        void SetMemoryBudget(size_t memoryBudget);
+
+        bool IsLoaded(const SessionKey& key) const { return _sessions.count(key) != 0; }
+        size_t Size() const noexcept { return _sessions.size(); }
+        size_t MemoryUsage() const noexcept { return _memoryUsage; }
+        size_t MemoryBudget() const noexcept { return _memoryBudget; }
+    private:
+        void Refresh(LoadedSession& loaded);
+        void EvictOverBudget();
+        void Drop(typename std::list<LoadedSession>::iterator it);
+    };
+
+    // -- both are explicitly instantiated in SessionManager.cpp...
+    extern template class BasicSessionManager<IReviewStrategy>;
+    extern template class BasicSessionManager<SuperMemo2ReviewStrategy>;
+
+    using SessionManager = BasicSessionManager<IReviewStrategy>;
+    using SuperMemo2SessionManager = BasicSessionManager<SuperMemo2ReviewStrategy>;
+}
@@ -0,0 +1,147 @@
+#include "Dejavu.h"
+
+using namespace jlimdev;
+
+// -- the memory budget is split evenly over the shards, each evicting on its own...
+// -- the shards' managers never load or save while running, that happens here outside their lock,
+// -- they only save what is still loaded when the manager goes away.
+template <typename Strategy>
+BasicShardedSessionManager<Strategy>::BasicShardedSessionManager(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard,
+    uint cardLimit, size_t memoryBudget, uint shardCount, typename Manager::LoadSession load, typename Manager::SaveSession save)
+    : _load(std::move(load)), _save(std::move(save))
+{
+    const uint shards = std::max(shardCount, 1U);
+
+    _shards.reserve(shards);
+
+    for (uint s = 0; s < shards; s++)
+    {
+        auto shard = std::make_unique<Shard>();
+        Shard* const owner = shard.get();
+
+        auto saveLoaded = [owner, save = _save](const SessionKey& key, Session& session)
+        {
+            auto slot = owner->slots.find(key);
+
+            if (save && slot != owner->slots.end() && slot->second->loaded)
+            {
+                save(key, session);
+            }
+        };
+
+        shard->sessions = std::make_unique<Manager>(reviewStrategy, maxNewCard, maxExistingCard, cardLimit,
+            memoryBudget / shards, nullptr, saveLoaded);
+        _shards.push_back(std::move(shard));
+    }
+}
+
+// -- the slot everyone working on the key's session shares, called with the shard mutex held...
+template <typename Strategy>
+std::shared_ptr<typename BasicShardedSessionManager<Strategy>::SessionSlot> BasicShardedSessionManager<Strategy>::SlotFor(Shard& shard, const SessionKey& key)
+{
+    std::shared_ptr<SessionSlot>& slot = shard.slots[key];
+
+    if (!slot)
+    {
+        slot = std::make_shared<SessionSlot>();
+    }
+
+    return slot;
+}
+
+// -- pin the coldest sessions under the shard mutex, then save each under its own lock with the shard free,
+// -- and only drop it once it is saved. a session someone picks up again meanwhile just stays loaded...
+template <typename Strategy>
+void BasicShardedSessionManager<Strategy>::EvictOverBudget(Shard& shard)
+{
+    std::vector<std::pair<SessionKey, Session*>> leaving;
+    std::vector<std::shared_ptr<SessionSlot>> slots;
+
+    {
+        std::lock_guard<std::mutex> shardGuard(shard.mutex);
+
+        shard.sessions->PinOverBudget(leaving);
+
+        for (const auto& session : leaving)
+        {
+            slots.push_back(SlotFor(shard, session.first));
+        }
+    }
+
+    for (size_t j = 0; j < leaving.size(); j++)
+    {
+        PinnedSession pinned(shard, leaving[j].first, std::move(slots[j]), true);
+
+        if (pinned.Slot().loaded && _save)
+        {
+            _save(leaving[j].first, *leaving[j].second);
+        }
+
+        pinned.DropOnRelease();
+    }
+}
+
+template <typename Strategy>
+std::optional<uint> BasicShardedSessionManager<Strategy>::NextReview(const SessionKey& key, Timestamp now)
+{
+    std::optional<uint> next;
+
+    WithSession(key, [&next, now](Session& session) { next = session.NextReview(now); });
+
+    return next;
+}
+
+// -- answer a card, giving back its next review time, or nothing if there is no such deck or card,
+// -- or the answer doesn't fit the deck's dates or couldn't be logged...
+template <typename Strategy>
+std::optional<Timestamp> BasicShardedSessionManager<Strategy>::UpdateCard(const SessionKey& key, uint i, ReviewOutcome outcome, Timestamp now)
+{
+    std::optional<Timestamp> nextReviewTime;
+
+    WithSession(key, [&nextReviewTime, i, outcome, now](Session& session)
+    {
+        if (i < session.Size())
+        {
+            nextReviewTime = session.UpdateCard(i, outcome, now);
+        }
+    });
+
+    return nextReviewTime;
+}
+
+template <typename Strategy>
+size_t BasicShardedSessionManager<Strategy>::Size()
+{
+    size_t size = 0;
+
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> shardGuard(shard->mutex);
+        size += shard->sessions->Size();
+    }
+
+    return size;
+}
+
+template <typename Strategy>
+size_t BasicShardedSessionManager<Strategy>::MemoryUsage()
+{
+    size_t memoryUsage = 0;
+
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> shardGuard(shard->mutex);
+        memoryUsage += shard->sessions->MemoryUsage();
+    }
+
+    return memoryUsage;
+}
+
+template <typename Strategy>
+typename BasicShardedSessionManager<Strategy>::Shard& BasicShardedSessionManager<Strategy>::ShardFor(const SessionKey& key)
+{
+    return *_shards[SessionKeyHash()(key) % _shards.size()];
+}
+
+template class jlimdev::BasicShardedSessionManager<IReviewStrategy>;
+template class jlimdev::BasicShardedSessionManager<SuperMemo2ReviewStrategy>;
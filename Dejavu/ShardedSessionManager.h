@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace jlimdev
+{
+    /// <summary>
+    /// Session manager that worker threads can share. Learners are spread over lock stripes, each a
+    /// BasicSessionManager behind its own mutex that is only held to find, pin and unpin a session,
+    /// and every session has a lock of its own that is held while it is loaded, worked on or saved.
+    /// So answers for different learners go on in parallel, and answers for the same learner one at a time,
+    /// and a slow load or save only holds up the learner it is for.
+    /// The load and save callbacks can be called from several threads at once.
+    /// </summary>
+    template <typename Strategy>
+    class BasicShardedSessionManager
+    {
+    public:
+        using Session = BasicStudySession<Strategy>;
+        using Manager = BasicSessionManager<Strategy>;
+
+    private:
+        // -- one per session the shard holds, kept by everyone who has it pinned...
+        struct SessionSlot
+        {
+            std::mutex mutex;
+            // -- both only change under the mutex: whether the loader filled the session, or had no such deck...
+            bool loaded = false;
+            bool missing = false;
+        };
+
+        struct Shard
+        {
+            std::mutex mutex;
+            // -- declared ahead of the sessions, so it is still there when they are saved on the way out...
+            std::unordered_map<SessionKey, std::shared_ptr<SessionSlot>, SessionKeyHash> slots;
+            std::unique_ptr<Manager> sessions;
+        };
+
+        /// <summary>
+        /// A pinned session with its lock held, unpinned again under the shard mutex however the holder leaves,
+        /// so a throwing work or save can't keep it pinned for good. Unpinning happens before the session lock
+        /// is let go, so the session is measured with nobody changing it.
+        /// </summary>
+        class PinnedSession
+        {
+        private:
+            Shard& _shard;
+            SessionKey _key;
+            std::shared_ptr<SessionSlot> _slot;
+            std::unique_lock<std::mutex> _lock;
+            bool _leaving;
+            bool _drop;
+
+        public:
+            PinnedSession(Shard& shard, const SessionKey& key, std::shared_ptr<SessionSlot> slot, bool leaving)
+                : _shard(shard), _key(key), _slot(std::move(slot)), _lock(_slot->mutex), _leaving(leaving), _drop(false)
+            {
+            }
+
+            PinnedSession(const PinnedSession&) = delete;
+            PinnedSession& operator=(const PinnedSession&) = delete;
+
+            ~PinnedSession()
+            {
+                std::lock_guard<std::mutex> shardGuard(_shard.mutex);
+
+                // -- nobody else has it pinned once it is dropped, so nobody else is holding its slot either...
+                if (_shard.sessions->Unpin(_key, _leaving, _drop || _slot->missing))
+                {
+                    _shard.slots.erase(_key);
+                }
+            }
+
+            SessionSlot& Slot() noexcept { return *_slot; }
+            void DropOnRelease() noexcept { _drop = true; }
+        };
+
+        std::vector<std::unique_ptr<Shard>> _shards;
+        typename Manager::LoadSession _load;
+        typename Manager::SaveSession _save;
+
+    public:
+        BasicShardedSessionManager(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit,
+            size_t memoryBudget, uint shardCount, typename Manager::LoadSession load, typename Manager::SaveSession save);
+        BasicShardedSessionManager(const BasicShardedSessionManager& m) = delete;
+        BasicShardedSessionManager& operator=(const BasicShardedSessionManager& m) = delete;
+
+        template <typename Work>
+        bool WithSession(const SessionKey& key, Work&& work);
+
+        std::optional<uint> NextReview(const SessionKey& key, Timestamp now);
+        std::optional<Timestamp> UpdateCard(const SessionKey& key, uint i, ReviewOutcome outcome, Timestamp now);
+
+        uint ShardCount() const noexcept { return static_cast<uint>(_shards.size()); }
+        size_t Size();
+        size_t MemoryUsage();
+    private:
+        Shard& ShardFor(const SessionKey& key);
+        std::shared_ptr<SessionSlot> SlotFor(Shard& shard, const SessionKey& key);
+        void EvictOverBudget(Shard& shard);
+    };
+
+    // -- run work on the learner's session, loading it if need be, with nobody else touching it...
+    // -- returns false, without running work, if the loader has no such deck.
+    // -- the shard mutex is only held to pin and unpin, loading happens under the session's own lock.
+    template <typename Strategy>
+    template <typename Work>
+    bool BasicShardedSessionManager<Strategy>::WithSession(const SessionKey& key, Work&& work)
+    {
+        Shard& shard = ShardFor(key);
+        Session* session = nullptr;
+        std::shared_ptr<SessionSlot> slot;
+
+        {
+            std::lock_guard<std::mutex> shardGuard(shard.mutex);
+
+            session = shard.sessions->Reserve(key);
+            slot = SlotFor(shard, key);
+        }
+
+        {
+            PinnedSession pinned(shard, key, std::move(slot), false);
+            SessionSlot& state = pinned.Slot();
+
+            // -- whoever gets to a fresh session first fills it, a loader that throws leaves it for the next one...
+            if (!state.loaded && !state.missing)
+            {
+                state.missing = !_load || !_load(key, *session);
+                state.loaded = !state.missing;
+            }
+
+            if (state.missing)
+            {
+                return false;
+            }
+
+            work(*session);
+        }
+
+        EvictOverBudget(shard);
+
+        return true;
+    }
+
+    // -- both are explicitly instantiated in ShardedSessionManager.cpp...
+    extern template class BasicShardedSessionManager<IReviewStrategy>;
+    extern template class BasicShardedSessionManager<SuperMemo2ReviewStrategy>;
+
+    using ShardedSessionManager = BasicShardedSessionManager<IReviewStrategy>;
+    using SuperMemo2ShardedSessionManager = BasicShardedSessionManager<SuperMemo2ReviewStrategy>;
+}
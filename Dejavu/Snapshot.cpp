@@ -0,0 +1,216 @@
+#include "Dejavu.h"
+#include <fstream>
+#include <string>
+
+#if __linux__
+#include <sys/mman.h>
+#endif
+
+#if _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace jlimdev;
+
+static size_t AlignSection(size_t offset) noexcept
+{
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+SnapshotLayout jlimdev::ComputeSnapshotLayout(const SnapshotHeader& header) noexcept
+{
+    const size_t cards = header.cardCount;
+    SnapshotLayout layout{};
+
+    layout.states = AlignSection(sizeof(SnapshotHeader));
+    layout.difficultyRatings = AlignSection(layout.states + cards * sizeof(CardState));
+    layout.reviewDates = AlignSection(layout.difficultyRatings + cards * sizeof(uint8_t));
+    layout.previousCorrectReviews = AlignSection(layout.reviewDates + cards * sizeof(DeckTime));
+    layout.dueAt = AlignSection(layout.previousCorrectReviews + cards * sizeof(DeckTime));
+    layout.visit = AlignSection(layout.dueAt + cards * sizeof(DeckTime));
+    layout.pending = AlignSection(layout.visit + cards * sizeof(ReviewState));
+    layout.wrong = AlignSection(layout.pending + header.pendingCount * sizeof(SnapshotPending));
+    layout.dueNew = AlignSection(layout.wrong + header.wrongCount * sizeof(uint32_t));
+    layout.dueExisting = AlignSection(layout.dueNew + header.dueNewCount * sizeof(uint32_t));
+    layout.size = AlignSection(layout.dueExisting + header.dueExistingCount * sizeof(uint32_t));
+
+    return layout;
+}
+
+MappedSnapshot::MappedSnapshot() noexcept
+    : _data(nullptr), _size(0), _mapped(false)
+{
+}
+
+MappedSnapshot::~MappedSnapshot()
+{
+    Close();
+}
+
+bool MappedSnapshot::Open(const char* path)
+{
+    Close();
+
+#if __linux__
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+
+    if (fstat(fd, &status) != 0 || status.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    _data = static_cast<const uint8_t*>(mapping);
+    _size = static_cast<size_t>(status.st_size);
+    _mapped = true;
+
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    const std::streamoff size = file.tellg();
+
+    if (size <= 0)
+    {
+        return false;
+    }
+
+    _buffer.resize(static_cast<size_t>(size));
+    file.seekg(0);
+
+    if (!file.read(reinterpret_cast<char*>(_buffer.data()), size))
+    {
+        _buffer.clear();
+        return false;
+    }
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+
+    return true;
+#endif
+}
+
+void MappedSnapshot::Close() noexcept
+{
+#if __linux__
+    if (_mapped)
+    {
+        munmap(const_cast<uint8_t*>(_data), _size);
+    }
+#endif
+
+    _buffer.clear();
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+// -- write data next to path, sync it, then rename it over path and sync the directory, so after a crash
+// -- path holds either everything it held before or everything in data, never a mix or a torn write...
+bool jlimdev::WriteFileAtomically(const char* path, const uint8_t* data, size_t size)
+{
+    const std::string temporary = std::string(path) + ".tmp";
+
+#if _WIN32
+    const HANDLE file = CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    bool written = true;
+
+    for (size_t offset = 0; written && offset < size;)
+    {
+        DWORD chunk = 0;
+        written = WriteFile(file, data + offset, static_cast<DWORD>(std::min<size_t>(size - offset, 1U << 30)), &chunk, nullptr) != 0;
+        offset += chunk;
+    }
+
+    written = written && FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+
+    // -- write through, so the rename is on disk before this returns...
+    if (!written || !MoveFileExA(temporary.c_str(), path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        DeleteFileA(temporary.c_str());
+        return false;
+    }
+
+    return true;
+#else
+    const int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    bool written = true;
+
+    for (size_t offset = 0; written && offset < size;)
+    {
+        const ssize_t chunk = write(fd, data + offset, size - offset);
+        written = chunk > 0;
+        offset += written ? static_cast<size_t>(chunk) : 0;
+    }
+
+    written = written && fsync(fd) == 0;
+    written = (close(fd) == 0) && written;
+
+    if (!written || std::rename(temporary.c_str(), path) != 0)
+    {
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    // -- the rename lives in the directory, which has to reach the disk too...
+    const std::string target(path);
+    const size_t slash = target.find_last_of('/');
+    const std::string directory = (slash == std::string::npos) ? "." : (slash == 0) ? "/" : target.substr(0, slash);
+    const int directoryFd = open(directory.c_str(), O_RDONLY);
+
+    if (directoryFd < 0)
+    {
+        return false;
+    }
+
+    const bool synced = fsync(directoryFd) == 0;
+    close(directoryFd);
+
+    return synced;
+#endif
+}
+
+bool jlimdev::WriteSnapshotFile(const char* path, const std::vector<uint8_t>& snapshot)
+{
+    return WriteFileAtomically(path, snapshot.data(), snapshot.size());
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jlimdev
+{
+    constexpr uint32_t SnapshotMagic = 0x53564a44U; // "DJVS" read as little-endian bytes
+    constexpr uint32_t SnapshotVersion = 1U;
+
+    /// <summary>
+    /// Fixed-width binary image of a StudySession, little-endian. The header is followed by one section per column,
+    /// each starting on an 8 byte boundary, in this order:
+    ///   card states (u8), difficulty ratings (u8), review dates (u32), previous correct reviews (u32),
+    ///   due times (u32), visit states (u8), pending cards (u32 due time, u32 index pairs, earliest first),
+    ///   wrong, due new and due existing queues (u32 indexes, ascending).
+    /// Per-card sections are laid out just as the session keeps them, so BorrowSnapshot can read them in place.
+    /// Dates and due times are deck times, seconds since the header's epoch (see CardStore).
+    /// Due times are the ones the writing session's strategy computed, so load with the same strategy
+    /// or call SetReviewStrategy afterwards. reviewSequence counts the answers folded in, see ReviewLog.
+    /// </summary>
+    struct SnapshotHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t cardCount;
+        uint32_t pendingCount;
+        uint32_t wrongCount;
+        uint32_t dueNewCount;
+        uint32_t dueExistingCount;
+        uint32_t newCardsReturned;
+        uint32_t existingCardsReturned;
+        uint32_t currentIndex;
+        uint32_t reviewSequence;
+        uint32_t reserved;
+        uint64_t epoch;
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 56);
+    static_assert(offsetof(SnapshotHeader, epoch) == 48);
+
+    // -- one entry of the pending section...
+    struct SnapshotPending
+    {
+        uint32_t dueAt;
+        uint32_t card;
+    };
+
+    static_assert(sizeof(SnapshotPending) == 8);
+
+    // -- byte offset of every section, worked out from the counts in the header...
+    struct SnapshotLayout
+    {
+        size_t states;
+        size_t difficultyRatings;
+        size_t reviewDates;
+        size_t previousCorrectReviews;
+        size_t dueAt;
+        size_t visit;
+        size_t pending;
+        size_t wrong;
+        size_t dueNew;
+        size_t dueExisting;
+        size_t size;
+    };
+
+    SnapshotLayout ComputeSnapshotLayout(const SnapshotHeader& header) noexcept;
+
+    /// <summary>
+    /// Read-only view of a snapshot file. Memory mapped on Linux so opening costs no reads up front,
+    /// read into memory everywhere else.
+    /// </summary>
+    class MappedSnapshot
+    {
+    private:
+        const uint8_t* _data;
+        size_t _size;
+        bool _mapped;
+        std::vector<uint8_t> _buffer;
+
+    public:
+        MappedSnapshot() noexcept;
+        MappedSnapshot(const MappedSnapshot& s) = delete;
+        MappedSnapshot& operator=(const MappedSnapshot& s) = delete;
+        ~MappedSnapshot();
+
+        bool Open(const char* path);
+        void Close() noexcept;
+
+        const uint8_t* Data() const noexcept { return _data; }
+        size_t Size() const noexcept { return _size; }
+    };
+
+    bool WriteFileAtomically(const char* path, const uint8_t* data, size_t size);
+    bool WriteSnapshotFile(const char* path, const std::vector<uint8_t>& snapshot);
+}
@@ -0,0 +1,167 @@
+#include "Dejavu.h"
+#include <cstring>
+
+#if DEJAVU_STATS
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif
+
+using namespace jlimdev;
+
+#if DEJAVU_STATS
+
+constexpr size_t counterCount = static_cast<size_t>(StatCounter::Count);
+constexpr size_t histogramCount = static_cast<size_t>(StatHistogram::Count);
+
+// -- each thread counts into its own block, written only by that thread, so counting is a plain load and store
+// -- with no locked instruction and no cache line bouncing between cores. readers sum every live block plus
+// -- what threads that have exited left behind...
+struct ThreadStats
+{
+    std::atomic<uint64_t> counters[counterCount];
+    std::atomic<uint64_t> histograms[histogramCount][StatHistogramBuckets];
+
+    ThreadStats() noexcept;
+    ~ThreadStats();
+
+    static void Add(std::atomic<uint64_t>& slot, uint64_t n) noexcept
+    {
+        slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+struct StatsRegistry
+{
+    std::mutex mutex;
+    std::vector<ThreadStats*> threads;
+    DejavuStats retired{};
+};
+
+static StatsRegistry& Registry() noexcept
+{
+    // -- leaked, so threads exiting after static destruction still have somewhere to retire to...
+    static StatsRegistry* registry = new StatsRegistry();
+
+    return *registry;
+}
+
+static ThreadStats& LocalStats() noexcept
+{
+    thread_local ThreadStats stats;
+
+    return stats;
+}
+
+ThreadStats::ThreadStats() noexcept
+{
+    for (std::atomic<uint64_t>& counter : counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    for (auto& histogram : histograms)
+    {
+        for (std::atomic<uint64_t>& bucket : histogram)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    StatsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    registry.threads.push_back(this);
+}
+
+ThreadStats::~ThreadStats()
+{
+    StatsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+
+    for (size_t c = 0; c < counterCount; c++)
+    {
+        registry.retired.counters[c] += counters[c].load(std::memory_order_relaxed);
+    }
+
+    for (size_t h = 0; h < histogramCount; h++)
+    {
+        for (size_t b = 0; b < StatHistogramBuckets; b++)
+        {
+            registry.retired.histograms[h][b] += histograms[h][b].load(std::memory_order_relaxed);
+        }
+    }
+
+    registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+}
+
+void jlimdev::CountStat(StatCounter counter, uint64_t n) noexcept
+{
+    ThreadStats::Add(LocalStats().counters[static_cast<size_t>(counter)], n);
+}
+
+void jlimdev::RecordStat(StatHistogram histogram, uint64_t value) noexcept
+{
+    ThreadStats::Add(LocalStats().histograms[static_cast<size_t>(histogram)][StatBucket(value)], 1);
+}
+
+void jlimdev::GetStats(DejavuStats& out) noexcept
+{
+    StatsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+
+    out = registry.retired;
+
+    for (const ThreadStats* stats : registry.threads)
+    {
+        for (size_t c = 0; c < counterCount; c++)
+        {
+            out.counters[c] += stats->counters[c].load(std::memory_order_relaxed);
+        }
+
+        for (size_t h = 0; h < histogramCount; h++)
+        {
+            for (size_t b = 0; b < StatHistogramBuckets; b++)
+            {
+                out.histograms[h][b] += stats->histograms[h][b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void jlimdev::ResetStats() noexcept
+{
+    StatsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+
+    registry.retired = DejavuStats{};
+
+    for (ThreadStats* stats : registry.threads)
+    {
+        for (std::atomic<uint64_t>& counter : stats->counters)
+        {
+            counter.store(0, std::memory_order_relaxed);
+        }
+
+        for (auto& histogram : stats->histograms)
+        {
+            for (std::atomic<uint64_t>& bucket : histogram)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+#else
+
+void jlimdev::GetStats(DejavuStats& out) noexcept
+{
+    std::memset(&out, 0, sizeof(out));
+}
+
+void jlimdev::ResetStats() noexcept
+{
+}
+
+#endif
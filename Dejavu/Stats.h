@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if DEJAVU_STATS
+#include <chrono>
+#endif
+
+// -- hot-path instrumentation, off unless DEJAVU_STATS is defined to 1 for the whole build. when off the
+// -- DEJAVU_STATS_* macros expand to nothing, so instrumented code compiles to exactly what it was before,
+// -- and GetStats hands back all zeros.
+
+namespace jlimdev
+{
+#if DEJAVU_STATS
+    constexpr bool StatsEnabled = true;
+#else
+    constexpr bool StatsEnabled = false;
+#endif
+
+    enum class StatCounter : uint32_t
+    {
+        NextReviewCalls,
+        // -- pending heap entries popped plus ready queue heads looked at, see NextReviewCardsScanned for the spread...
+        CardsScanned,
+        // -- cards handed out after checking they are due, and cards a due check turned away, one per check...
+        DueHits,
+        DueMisses,
+        UpdateCardCalls,
+        StrategyNextReviewCalls,
+        // -- cards scheduled through NextReviewBatch and NextReviewColumns...
+        StrategyBatchCards,
+        StrategyAdjustDifficultyCalls,
+        Count
+    };
+
+    enum class StatHistogram : uint32_t
+    {
+        NextReviewNanoseconds,
+        UpdateCardNanoseconds,
+        NextReviewCardsScanned,
+        Count
+    };
+
+    // -- bucket 0 counts zeros, bucket b values in [2^(b-1), 2^b), the last bucket everything above...
+    constexpr uint32_t StatHistogramBuckets = 32;
+
+    /// <summary>
+    /// Every counter and histogram, summed over all threads. Plain uint64s in a fixed layout so the
+    /// bridge can hand it to javascript as is: counters first, then the histograms row after row.
+    /// </summary>
+    struct DejavuStats
+    {
+        uint64_t counters[static_cast<size_t>(StatCounter::Count)];
+        uint64_t histograms[static_cast<size_t>(StatHistogram::Count)][StatHistogramBuckets];
+
+        uint64_t Counter(StatCounter counter) const noexcept { return counters[static_cast<size_t>(counter)]; }
+        const uint64_t* Histogram(StatHistogram histogram) const noexcept { return histograms[static_cast<size_t>(histogram)]; }
+    };
+
+    void GetStats(DejavuStats& out) noexcept;
+
+    // -- counts from threads running at the time may land on either side of the reset...
+    void ResetStats() noexcept;
+
+    constexpr uint32_t StatBucket(uint64_t value) noexcept
+    {
+        uint32_t bucket = 0;
+
+        while (value != 0 && bucket + 1 < StatHistogramBuckets)
+        {
+            value >>= 1;
+            bucket++;
+        }
+
+        return bucket;
+    }
+
+#if DEJAVU_STATS
+    void CountStat(StatCounter counter, uint64_t n) noexcept;
+    void RecordStat(StatHistogram histogram, uint64_t value) noexcept;
+
+    /// <summary>
+    /// Records the nanoseconds from construction to destruction into a latency histogram.
+    /// </summary>
+    class ScopedStatTimer
+    {
+        StatHistogram _histogram;
+        std::chrono::steady_clock::time_point _start;
+
+    public:
+        explicit ScopedStatTimer(StatHistogram histogram) noexcept : _histogram(histogram), _start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ScopedStatTimer(const ScopedStatTimer&) = delete;
+        ScopedStatTimer& operator=(const ScopedStatTimer&) = delete;
+
+        ~ScopedStatTimer()
+        {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+
+            RecordStat(_histogram, static_cast<uint64_t>(elapsed.count()));
+        }
+    };
+
+    /// <summary>
+    /// Adds up a count over one call, then records it into a counter and into a histogram of per-call counts.
+    /// </summary>
+    class ScopedStatTally
+    {
+        StatCounter _counter;
+        StatHistogram _histogram;
+        uint64_t _value;
+
+    public:
+        ScopedStatTally(StatCounter counter, StatHistogram histogram) noexcept : _counter(counter), _histogram(histogram), _value(0)
+        {
+        }
+
+        ScopedStatTally(const ScopedStatTally&) = delete;
+        ScopedStatTally& operator=(const ScopedStatTally&) = delete;
+
+        void Add(uint64_t n) noexcept { _value += n; }
+
+        ~ScopedStatTally()
+        {
+            CountStat(_counter, _value);
+            RecordStat(_histogram, _value);
+        }
+    };
+#endif
+}
+
+#if DEJAVU_STATS
+#define DEJAVU_STATS_COUNT(counter, n) ::jlimdev::CountStat(::jlimdev::StatCounter::counter, (n))
+#define DEJAVU_STATS_RECORD(histogram, value) ::jlimdev::RecordStat(::jlimdev::StatHistogram::histogram, (value))
+#define DEJAVU_STATS_TIMER(histogram) const ::jlimdev::ScopedStatTimer dejavuStatTimer(::jlimdev::StatHistogram::histogram)
+#define DEJAVU_STATS_TALLY(name, counter, histogram) ::jlimdev::ScopedStatTally name(::jlimdev::StatCounter::counter, ::jlimdev::StatHistogram::histogram)
+#define DEJAVU_STATS_ADD(name, n) name.Add(n)
+#else
+#define DEJAVU_STATS_COUNT(counter, n) ((void)0)
+#define DEJAVU_STATS_RECORD(histogram, value) ((void)0)
+#define DEJAVU_STATS_TIMER(histogram) ((void)0)
+#define DEJAVU_STATS_TALLY(name, counter, histogram) ((void)0)
+#define DEJAVU_STATS_ADD(name, n) ((void)0)
+#endif
@@ -1,4 +1,6 @@
 #include "Dejavu.h"
+#include <cstdlib>
+#include <cstring>
 
 using namespace jlimdev;
 
@@ -26,139 +28,1076 @@ struct ReviewItemAfterCorrect
     }
 };
 
-StudySession::StudySession(const IReviewStrategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit) noexcept
-    : _reviewStrategy(reviewStrategy), _newCardsReturned(0), _existingCardsReturned(0),
+// -- earliest and latest date an item carries, DueImmediately for both when it has none...
+struct ReviewItemDates
+{
+    std::pair<Timestamp, Timestamp> operator()(const NeverReviewed& n)
+    {
+        return { DueImmediately, DueImmediately };
+    }
+    std::pair<Timestamp, Timestamp> operator()(const PreviouslyIncorrect& p)
+    {
+        return { p.reviewDate, p.reviewDate };
+    }
+    std::pair<Timestamp, Timestamp> operator()(const PreviouslyFirstCorrect& p)
+    {
+        return { p.reviewDate, p.reviewDate };
+    }
+    std::pair<Timestamp, Timestamp> operator()(const PreviouslyCorrect& p)
+    {
+        return std::minmax(p.reviewDate, p.previousCorrectReview);
+    }
+};
+
+template <typename Strategy>
+BasicStudySession<Strategy>::BasicStudySession(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit,
+    std::pmr::memory_resource* upstream)
+    : _reviewStrategy(&reviewStrategy), _arena(upstream), _newCardsReturned(0), _existingCardsReturned(0),
       _newCardMax(maxNewCard), _existingCardMax(maxExistingCard), _currentIndex(0), 
-      _cardLimit(cardLimit)
+      _cardLimit(cardLimit), _cards(&_arena), _dueAt(&_arena), _visit(&_arena), _pending(&_arena),
+      _pendingRun(nullptr), _pendingRunEnd(nullptr),
+      _wrong(&_arena), _dueNew(&_arena), _dueExisting(&_arena), _order(ReviewOrder::RoundRobin), _ranked(&_arena),
+      _dirty(&_arena), _isDirty(&_arena),
+      _reviewSequence(0), _reviewLog(nullptr), _streamTotal(0)
 {
 }
 
-void StudySession::Reset()
+// -- containers keep their capacity and queue nodes go back to the arena, so nothing is freed to the heap...
+template <typename Strategy>
+void BasicStudySession<Strategy>::Reset()
 {
-    _cards.clear();
+    _cards.Clear();
+    _dueAt.clear();
     _visit.clear();
+    _pending.clear();
+    _pendingRun = nullptr;
+    _pendingRunEnd = nullptr;
+    _wrong.clear();
+    _dueNew.clear();
+    _dueExisting.clear();
+    _ranked.clear();
+    _dirty.clear();
+    _isDirty.clear();
     _newCardsReturned = 0;
     _existingCardsReturned = 0;
     _currentIndex = 0;
+    _reviewSequence = 0;
+    _streamTotal = 0;
+    _loader = nullptr;
 }
 
-void StudySession::AddNeverReviewed()
+template <typename Strategy>
+bool BasicStudySession<Strategy>::AddNeverReviewed()
 {
     // -- this seems kind of a problem. Not sure how to start it off if it has no history.
     // -- in the original code, Never Reviewed test case started with easiest...
     // -- but seems like would want more reviews initially for new stuff...
     // -- so changing it to most difficult...
-    AddItem(NeverReviewed{ DifficultyRatingMostDifficult });
+    return AddItem(NeverReviewed{ DifficultyRatingMostDifficult });
 }
 
-void StudySession::AddPreviouslyIncorrect(uint difficultyRating, Timestamp reviewDate)
+template <typename Strategy>
+bool BasicStudySession<Strategy>::AddPreviouslyIncorrect(uint difficultyRating, Timestamp reviewDate)
 {
-    AddItem(PreviouslyIncorrect{ difficultyRating, reviewDate });
+    return AddItem(PreviouslyIncorrect{ difficultyRating, reviewDate });
 }
 
-void StudySession::AddPreviouslyFirstCorrect(uint difficultyRating, Timestamp reviewDate)
+template <typename Strategy>
+bool BasicStudySession<Strategy>::AddPreviouslyFirstCorrect(uint difficultyRating, Timestamp reviewDate)
 {
-    AddItem(PreviouslyFirstCorrect{ difficultyRating, reviewDate });
+    return AddItem(PreviouslyFirstCorrect{ difficultyRating, reviewDate });
 }
 
-void StudySession::AddPreviouslyCorrect(uint difficultyRating, Timestamp reviewDate, Timestamp previousCorrectReview)
+template <typename Strategy>
+bool BasicStudySession<Strategy>::AddPreviouslyCorrect(uint difficultyRating, Timestamp reviewDate, Timestamp previousCorrectReview)
 {
-    AddItem(PreviouslyCorrect{ difficultyRating, reviewDate, previousCorrectReview });
+    return AddItem(PreviouslyCorrect{ difficultyRating, reviewDate, previousCorrectReview });
 }
 
-uint StudySession::UpdateCard(uint i, const ReviewOutcome& outcome, uint now)
+// -- returns the card's next review time, or nothing, with the card left as it was, for an answer more than
+// -- a deck time away from the deck's other dates or one the attached review log couldn't write.
+// -- the answer is logged before it is applied, so a restore never comes back without it...
+template <typename Strategy>
+std::optional<Timestamp> BasicStudySession<Strategy>::UpdateCard(uint i, const ReviewOutcome& outcome, Timestamp now)
 {
-    _cards.at(i) = MapItem(i, outcome, now);
+    DEJAVU_STATS_TIMER(UpdateCardNanoseconds);
+    DEJAVU_STATS_COUNT(UpdateCardCalls, 1);
+
+    if (!FitDeckTime(now, now) || (_reviewLog != nullptr && !_reviewLog->Append(i, outcome, now)))
+    {
+        return std::nullopt;
+    }
+
+    const ReviewItem item = MapItem(i, outcome, now);
+
+    _cards.Set(i, item);
+    _dueAt.Set(i, DueAt(item));
+    MarkDirty(i);
+
+    _reviewSequence++;
 
     return GetNextReviewTime(i, now);
 }
 
-uint StudySession::GetNextReviewTime(uint i, uint now) const
+template <typename Strategy>
+Timestamp BasicStudySession<Strategy>::GetNextReviewTime(uint i, Timestamp now) const
+{
+    const Timestamp dueAt = _cards.FromDeckTime(_dueAt.at(i));
+
+    return (dueAt == DueImmediately) ? now : dueAt;
+}
+
+// -- next review time of every card in the deck, out must have room for the whole deck...
+template <typename Strategy>
+void BasicStudySession<Strategy>::GetNextReviewTimes(Timestamp now, Timestamp* out) const
+{
+    for (uint i = 0; i < _cards.Size(); i++)
+    {
+        out[i] = (_dueAt[i] == 0) ? now : _cards.FromDeckTime(_dueAt[i]);
+    }
+}
+
+// -- cards coming due on each of the next days days, from the cached due times, see jlimdev::ForecastDueCounts...
+template <typename Strategy>
+void BasicStudySession<Strategy>::ForecastDueCounts(Timestamp now, uint days, uint* counts, uint threads) const
 {
-    return _reviewStrategy.NextReview(_cards.at(i), now);
+    jlimdev::ForecastDueCounts(_dueAt.data(), _dueAt.size(), _cards.ToDeckTime(now), days, counts, threads);
 }
 
-const ReviewItem& StudySession::At(uint i) const
+template <typename Strategy>
+ReviewItem BasicStudySession<Strategy>::At(uint i) const
 {
-    return _cards.at(i);
+    return _cards.At(i);
+}
+
+// -- due times belong to the strategy that computed them, so swapping it reschedules every card...
+template <typename Strategy>
+void BasicStudySession<Strategy>::SetReviewStrategy(const Strategy& reviewStrategy)
+{
+    _reviewStrategy = &reviewStrategy;
+
+    RebuildDueTimes();
 }
 
 // returns optional of index of next card or null option if done
-std::optional<uint> StudySession::NextReview(Timestamp now)
+template <typename Strategy>
+std::optional<uint> BasicStudySession<Strategy>::NextReview(Timestamp timestamp)
 {
     // -- finda card to review
 
-    for (uint iCount = 0; iCount < _cards.size(); iCount++)
+    DEJAVU_STATS_TIMER(NextReviewNanoseconds);
+    DEJAVU_STATS_TALLY(scanned, CardsScanned, NextReviewCardsScanned);
+    DEJAVU_STATS_COUNT(NextReviewCalls, 1);
+
+    // -- due times are compared in deck time, so the clock is converted once instead of every card...
+    DeckTime now = _cards.ToDeckTime(timestamp);
+
+    [[maybe_unused]] const uint popped = PromoteDueCards(now);
+    DEJAVU_STATS_ADD(scanned, popped);
+
+    for (;;)
     {
-        // cycle through the entire vector starting from current index...
-        const uint i = (_currentIndex + iCount) % _cards.size();
-        const uint nextI = (i + 1) % _cards.size();
+        // -- same order as cycling through the entire vector starting from current index,
+        // -- but only looking at the head of each queue that could still hand out a card...
+        const bool newAllowed = _newCardsReturned + 1 <= _newCardMax;
+        const bool existingAllowed = _existingCardsReturned + 1 <= _existingCardMax;
 
-        if (_visit.at(i) == ReviewState::Wrong)
+        std::optional<uint> wrong = NextInRoundRobin(_wrong);
+        std::optional<uint> dueNew = newAllowed ? NextInRoundRobin(_dueNew) : std::nullopt;
+        std::optional<uint> dueExisting = existingAllowed ? NextExisting() : std::nullopt;
+
+        std::optional<uint> next;
+        uint nextDistance = 0;
+
+        for (const std::optional<uint>& candidate : { wrong, dueNew, dueExisting })
+        {
+            if (!candidate)
+            {
+                continue;
+            }
+
+            DEJAVU_STATS_ADD(scanned, 1);
+
+            const uint distance = (*candidate + _cards.Size() - _currentIndex) % _cards.Size();
+
+            if (!next || distance < nextDistance)
+            {
+                next = candidate;
+                nextDistance = distance;
+            }
+        }
+
+        // -- streaming: cards behind the current index only come up once everything after it has been looked at,
+        // -- so load the rest of the deck first, one chunk at a time, to hand out cards in the order the whole deck would.
+        // -- with both caps used up only wrong cards are left, and those are all loaded already...
+        if ((newAllowed || existingAllowed) && (!next || *next < _currentIndex) && LoadNextChunk())
+        {
+            now = _cards.ToDeckTime(timestamp);
+
+            [[maybe_unused]] const uint loaded = PromoteDueCards(now);
+            DEJAVU_STATS_ADD(scanned, loaded);
+            continue;
+        }
+
+        if (!next)
+        {
+            return std::nullopt;
+        }
+
+        // -- until the deck is all in, the round robin carries on past the last loaded card instead of wrapping...
+        const uint i = *next;
+        const uint nextI = FullyLoaded() ? (i + 1) % _cards.Size() : i + 1;
+
+        if (next == wrong)
         {
             _currentIndex = nextI;
             // wrong will always be marked for review until it is right...
-            return std::optional<uint>(i);
+            return next;
         }
-        else if (_visit.at(i) == ReviewState::Unvisited)
+
+        // -- time went backwards since this card was promoted, so park it again...
+        if (!IsDue(i, now))
         {
-            // unvisited cards usually get reviewed, but put a cap on them since session time has limited attention span...
-            if (IsDue(_cards.at(i), now) && IsNewItem(_cards.at(i)) && _newCardsReturned + 1 <= _newCardMax)
+            DEJAVU_STATS_COUNT(DueMisses, 1);
+
+            if (next == dueNew)
             {
-                _newCardsReturned++;
-                _currentIndex = nextI;
-                return std::optional<uint>(i);
+                _dueNew.erase(i);
             }
-            else if (IsDue(_cards.at(i), now) && !IsNewItem(_cards.at(i)) && _existingCardsReturned + 1 <= _existingCardMax)
+            else
             {
-                _existingCardsReturned++;
-                _currentIndex = nextI;
-                return std::optional<uint>(i);
+                UnqueueExisting(i);
+            }
+
+            PushPending(_dueAt[i], i);
+            continue;
+        }
+
+        DEJAVU_STATS_COUNT(DueHits, 1);
+
+        // unvisited cards usually get reviewed, but put a cap on them since session time has limited attention span...
+        if (next == dueNew)
+        {
+            _newCardsReturned++;
+        }
+        else
+        {
+            _existingCardsReturned++;
+        }
+
+        _currentIndex = nextI;
+        return next;
+    }
+}
+
+// -- move one card into its ready queue ahead of NextReview, for a DueScheduler that saw its time come;
+// -- false if it isn't due yet or has already been answered. its pending entry is dropped later like any other...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::PromoteCard(uint i, Timestamp now)
+{
+    if (i >= _cards.Size() || _visit[i] != ReviewState::Unvisited)
+    {
+        return false;
+    }
+
+    if (!IsDue(i, _cards.ToDeckTime(now)))
+    {
+        DEJAVU_STATS_COUNT(DueMisses, 1);
+        return false;
+    }
+
+    if (IsNewItem(i))
+    {
+        _dueNew.insert(i);
+    }
+    else
+    {
+        QueueExisting(i);
+    }
+
+    return true;
+}
+
+// -- false, without adding it, once the deck is full or for dates too far from the deck's other dates...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::AddItem(const ReviewItem& item)
+{
+    const std::pair<Timestamp, Timestamp> dates = std::visit(ReviewItemDates{}, item);
+
+    if (_cards.Size() >= _cardLimit || !FitDeckTime(dates.first, dates.second))
+    {
+        return false;
+    }
+
+    const DeckTime dueAt = DueAt(item);
+
+    _cards.Add(item);
+    _dueAt.push_back(dueAt);
+    _visit.push_back(ReviewState::Unvisited);
+    PushPending(dueAt, _cards.Size() - 1);
+
+    return true;
+}
+
+// -- room for a deck of count cards in one allocation per column, so adding them card by card never reallocates...
+template <typename Strategy>
+void BasicStudySession<Strategy>::Reserve(uint count)
+{
+    _cards.Reserve(count);
+    _dueAt.reserve(count);
+    _visit.reserve(count);
+    _pending.reserve(count);
+    _dirty.reserve(count);
+    _isDirty.reserve(count);
+}
+
+// -- bulk load: validate and append a whole block of records, then schedule the block in one strategy call...
+// -- returns how many records were added, stopping at the first bad one or once the deck is full.
+template <typename Strategy>
+uint BasicStudySession<Strategy>::ImportRecords(const DeckRecord* records, uint count)
+{
+    const uint first = _cards.Size();
+
+    count = std::min(count, _cardLimit - std::min(first, _cardLimit));
+    Reserve(first + count);
+
+    uint added = 0;
+
+    for (; added < count; added++)
+    {
+        const DeckRecord& record = records[added];
+
+        if (record.state > CardState::PreviouslyCorrect ||
+            record.difficultyRating > DifficultyRatingMostDifficult ||
+            (record.state == CardState::PreviouslyCorrect && record.previousCorrectReview == 0))
+        {
+            break;
+        }
+
+        // -- fields the state doesn't have are dropped, same as going through the variant...
+        const bool hasReviewDate = record.state != CardState::NeverReviewed;
+        const bool hasPreviousCorrectReview = record.state == CardState::PreviouslyCorrect;
+
+        if (hasReviewDate)
+        {
+            const Timestamp previous = hasPreviousCorrectReview ? record.previousCorrectReview : record.reviewDate;
+
+            if (!FitDeckTime(std::min(record.reviewDate, previous), std::max(record.reviewDate, previous)))
+            {
+                break;
             }
         }
+
+        _cards.Add(record.state, record.difficultyRating,
+            hasReviewDate ? record.reviewDate : 0,
+            hasPreviousCorrectReview ? record.previousCorrectReview : 0);
+        _visit.push_back(ReviewState::Unvisited);
+    }
+
+    _dueAt.resize(first + added);
+    _reviewStrategy->NextReviewColumns(_cards, first, added, DueImmediately, _dueAt.MutableData() + first);
+
+    const size_t heapSize = _pending.size();
+
+    for (uint i = first; i < first + added; i++)
+    {
+        _pending.emplace_back(_dueAt[i], i);
+    }
+
+    // -- a chunk smaller than the heap it joins is cheaper to push card by card than to heapify everything again...
+    if (added < heapSize)
+    {
+        for (size_t j = heapSize + 1; j <= _pending.size(); j++)
+        {
+            std::push_heap(_pending.begin(), _pending.begin() + j, std::greater<PendingCard>());
+        }
+    }
+    else
+    {
+        std::make_heap(_pending.begin(), _pending.end(), std::greater<PendingCard>());
     }
 
-    return std::nullopt;
+    return added;
 }
 
-void StudySession::AddItem(const ReviewItem& item)
+// -- streaming load: the deck will hold totalCards, but only has to be imported up to its first chunk before
+// -- NextReview can hand out cards. the rest come in through ImportRecords as they arrive, or from loader,
+// -- which NextReview calls whenever it would otherwise pass over cards not loaded yet...
+template <typename Strategy>
+void BasicStudySession<Strategy>::StreamDeck(uint totalCards, ChunkLoader loader)
 {
-    if (_cards.size() > _cardLimit)
+    _streamTotal = std::min(totalCards, _cardLimit);
+    _loader = std::move(loader);
+
+    Reserve(_streamTotal);
+}
+
+// -- pull the next chunk of a streamed deck, e.g. while the learner is reading a card. false once there is
+// -- nothing more to load; a loader that comes back empty handed ends the stream, so the deck is taken as complete...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::LoadNextChunk()
+{
+    if (FullyLoaded() || !_loader)
     {
-        exit(1);
+        return false;
     }
 
-    _cards.emplace_back(item);
-    _visit.emplace_back(ReviewState::Unvisited);
+    const uint loaded = _cards.Size();
+
+    if (!_loader(*this) || _cards.Size() == loaded)
+    {
+        _streamTotal = _cards.Size();
+    }
+
+    return _cards.Size() > loaded;
 }
 
 // -- make next state transition by using user response and pattern matching on current card...
-ReviewItem StudySession::MapItem(uint i, const ReviewOutcome& outcome, Timestamp now)
+template <typename Strategy>
+ReviewItem BasicStudySession<Strategy>::MapItem(uint i, const ReviewOutcome& outcome, Timestamp now)
 {
-    const ReviewItem& item = _cards.at(i);
-    const DifficultyRating difficultyRating = _reviewStrategy.AdjustDifficulty(item, outcome);
+    const ReviewItem item = _cards.At(i);
+    const DifficultyRating difficultyRating = _reviewStrategy->AdjustDifficulty(item, outcome);
+
+    // -- once answered, a card is only ever handed out again if it was wrong...
+    _dueNew.erase(i);
+    UnqueueExisting(i);
 
     if (outcome == ReviewOutcome::Incorrect)
     {
-        _visit.at(i) = ReviewState::Wrong;
+        _visit.Set(i, ReviewState::Wrong);
+        _wrong.insert(i);
         
         return std::move(PreviouslyIncorrect{ difficultyRating, now });
     }
     else
     {
-        _visit.at(i) = ReviewState::Visited;
+        _visit.Set(i, ReviewState::Visited);
+        _wrong.erase(i);
 
         return std::visit(ReviewItemAfterCorrect{ now, difficultyRating }, item);
     }
 }
 
-bool StudySession::IsDue(const ReviewItem& item, const Timestamp& now) const
+template <typename Strategy>
+bool BasicStudySession<Strategy>::IsDue(uint i, DeckTime now) const
+{
+    return _dueAt[i] <= now;
+}
+
+template <typename Strategy>
+bool BasicStudySession<Strategy>::IsNewItem(uint i) const
+{
+    return _cards.State(i) == CardState::NeverReviewed;
+}
+
+// -- asking the strategy at the epoch gives the earliest time the card can come up...
+template <typename Strategy>
+DeckTime BasicStudySession<Strategy>::DueAt(const ReviewItem& item) const
+{
+    return _cards.ToDeckTime(_reviewStrategy->NextReview(item, DueImmediately));
+}
+
+// -- make sure dates from earliest to latest can be stored, moving the deck's epoch if they can't yet,
+// -- false if they're too far from the dates already in the deck. DueImmediately for both means no dates...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::FitDeckTime(Timestamp earliest, Timestamp latest)
+{
+    if (latest == DueImmediately || (_cards.Fits(earliest) && _cards.Fits(latest)))
+    {
+        return true;
+    }
+
+    const Timestamp epoch = _cards.Epoch();
+
+    if (!_cards.Rebase(earliest, latest))
+    {
+        return false;
+    }
+
+    // -- every due time moves the same way, so the pending heap stays a heap, but ranks are worked out from due times...
+    const auto rebase = [this, epoch](DeckTime t) { return _cards.ToDeckTime((t == 0) ? DueImmediately : epoch + t); };
+
+    DeckTime* dueAt = _dueAt.MutableData();
+
+    for (uint i = 0; i < _dueAt.size(); i++)
+    {
+        dueAt[i] = rebase(dueAt[i]);
+    }
+
+    MergePendingRun();
+
+    for (PendingCard& card : _pending)
+    {
+        card.first = rebase(card.first);
+    }
+
+    RankExisting();
+
+    return true;
+}
+
+// -- bulk save: every card's columns plus its next review time, out must have room for the whole deck...
+template <typename Strategy>
+void BasicStudySession<Strategy>::ExportRecords(Timestamp now, ExportedRecord* out) const
+{
+    for (uint i = 0; i < _cards.Size(); i++)
+    {
+        out[i] = ExportRecord(i, now);
+    }
+}
+
+// -- incremental save: only the cards answered since the last commit, out must have room for DirtyCards().size()...
+template <typename Strategy>
+void BasicStudySession<Strategy>::ExportDirtyRecords(Timestamp now, ExportedRecord* out) const
+{
+    for (size_t j = 0; j < _dirty.size(); j++)
+    {
+        out[j] = ExportRecord(_dirty[j], now);
+    }
+}
+
+// -- the caller has saved the dirty cards, start tracking afresh...
+template <typename Strategy>
+void BasicStudySession<Strategy>::CommitDirtyCards() noexcept
+{
+    for (const uint i : _dirty)
+    {
+        _isDirty[i] = false;
+    }
+
+    _dirty.clear();
+}
+
+template <typename Strategy>
+void BasicStudySession<Strategy>::MarkDirty(uint i)
+{
+    if (_isDirty.size() < _cards.Size())
+    {
+        _isDirty.resize(_cards.Size());
+    }
+
+    if (!_isDirty[i])
+    {
+        _isDirty[i] = true;
+        _dirty.push_back(i);
+    }
+}
+
+template <typename Strategy>
+ExportedRecord BasicStudySession<Strategy>::ExportRecord(uint i, Timestamp now) const
+{
+    const DeckRecord card{ _cards.States()[i], _cards.DifficultyRatings()[i], 0, _cards.ReviewDate(i), _cards.PreviousCorrectReview(i) };
+
+    return ExportedRecord{ card, i, GetNextReviewTime(i, now) };
+}
+
+// -- whole session state as one snapshot image, see SnapshotHeader for the layout...
+template <typename Strategy>
+void BasicStudySession<Strategy>::SaveSnapshot(std::vector<uint8_t>& out) const
+{
+    SnapshotHeader header{};
+    header.magic = SnapshotMagic;
+    header.version = SnapshotVersion;
+    header.cardCount = _cards.Size();
+    header.pendingCount = static_cast<uint32_t>(_pending.size() + (_pendingRunEnd - _pendingRun));
+    header.wrongCount = static_cast<uint32_t>(_wrong.size());
+    header.dueNewCount = static_cast<uint32_t>(_dueNew.size());
+    header.dueExistingCount = static_cast<uint32_t>(_dueExisting.size());
+    header.newCardsReturned = _newCardsReturned;
+    header.existingCardsReturned = _existingCardsReturned;
+    header.currentIndex = _currentIndex;
+    header.reviewSequence = _reviewSequence;
+    header.epoch = _cards.Epoch();
+
+    const SnapshotLayout layout = ComputeSnapshotLayout(header);
+    const size_t cards = _cards.Size();
+
+    out.assign(layout.size, 0);
+    uint8_t* data = out.data();
+
+    std::memcpy(data, &header, sizeof(header));
+    std::memcpy(data + layout.states, _cards.States().data(), cards * sizeof(CardState));
+    std::memcpy(data + layout.difficultyRatings, _cards.DifficultyRatings().data(), cards * sizeof(uint8_t));
+    std::memcpy(data + layout.reviewDates, _cards.ReviewDates().data(), cards * sizeof(DeckTime));
+    std::memcpy(data + layout.previousCorrectReviews, _cards.PreviousCorrectReviews().data(), cards * sizeof(DeckTime));
+    std::memcpy(data + layout.dueAt, _dueAt.data(), cards * sizeof(DeckTime));
+    std::memcpy(data + layout.visit, _visit.data(), cards * sizeof(ReviewState));
+
+    // -- written earliest first, which is a heap as it stands and lets a borrowing load take cards off the front...
+    SnapshotPending* pending = reinterpret_cast<SnapshotPending*>(data + layout.pending);
+    SnapshotPending* next = std::copy(_pendingRun, _pendingRunEnd, pending);
+
+    for (const PendingCard& card : _pending)
+    {
+        *next++ = SnapshotPending{ card.first, card.second };
+    }
+
+    std::sort(pending, next, [](const SnapshotPending& a, const SnapshotPending& b)
+    {
+        return PendingCard(a.dueAt, a.card) < PendingCard(b.dueAt, b.card);
+    });
+
+    std::copy(_wrong.begin(), _wrong.end(), reinterpret_cast<uint32_t*>(data + layout.wrong));
+    std::copy(_dueNew.begin(), _dueNew.end(), reinterpret_cast<uint32_t*>(data + layout.dueNew));
+    std::copy(_dueExisting.begin(), _dueExisting.end(), reinterpret_cast<uint32_t*>(data + layout.dueExisting));
+}
+
+// -- replace the session with a copy of a snapshot image, so the image can go away straight after...
+// -- the pending cards are taken as written, so nothing is rescheduled.
+// -- returns false, leaving the session empty, if the image is not one this version wrote.
+template <typename Strategy>
+bool BasicStudySession<Strategy>::LoadSnapshot(const uint8_t* data, size_t size)
+{
+    return ReadSnapshot(data, size, false);
+}
+
+// -- same as LoadSnapshot, but the per-card columns and pending cards are read in place, e.g. out of a MappedSnapshot,
+// -- so opening a deck costs a check of its state bytes rather than a copy. a column is only copied in once the
+// -- session writes to it. data has to stay valid until the session is reset or loads again...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::BorrowSnapshot(const uint8_t* data, size_t size)
+{
+    return ReadSnapshot(data, size, true);
+}
+
+template <typename Strategy>
+bool BasicStudySession<Strategy>::ReadSnapshot(const uint8_t* data, size_t size, bool borrow)
+{
+    Reset();
+
+    SnapshotHeader header{};
+
+    if (data == nullptr || size < sizeof(header))
+    {
+        return false;
+    }
+
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != SnapshotMagic || header.version != SnapshotVersion ||
+        header.cardCount > _cardLimit || header.currentIndex > header.cardCount ||
+        ComputeSnapshotLayout(header).size > size)
+    {
+        return false;
+    }
+
+    const SnapshotLayout layout = ComputeSnapshotLayout(header);
+    const uint cards = header.cardCount;
+
+    const CardState* states = reinterpret_cast<const CardState*>(data + layout.states);
+    const uint8_t* difficultyRatings = data + layout.difficultyRatings;
+    const ReviewState* visit = reinterpret_cast<const ReviewState*>(data + layout.visit);
+
+    // -- the visitors and queues trust these to be in range, so a damaged or hostile image stops here...
+    if (!std::all_of(states, states + cards, [](CardState state) { return state <= CardState::PreviouslyCorrect; }) ||
+        !std::all_of(difficultyRatings, difficultyRatings + cards, [](uint8_t rating) { return rating <= DifficultyRatingMostDifficult; }) ||
+        !std::all_of(visit, visit + cards, [](ReviewState state) { return state <= ReviewState::Wrong; }))
+    {
+        return false;
+    }
+
+    const DeckTime* reviewDates = reinterpret_cast<const DeckTime*>(data + layout.reviewDates);
+    const DeckTime* previousCorrectReviews = reinterpret_cast<const DeckTime*>(data + layout.previousCorrectReviews);
+    const DeckTime* dueAt = reinterpret_cast<const DeckTime*>(data + layout.dueAt);
+    const SnapshotPending* pending = reinterpret_cast<const SnapshotPending*>(data + layout.pending);
+
+    if (borrow)
+    {
+        _cards.Borrow(states, difficultyRatings, reviewDates, previousCorrectReviews, cards, header.epoch);
+        _dueAt.Borrow(dueAt, cards);
+        _visit.Borrow(visit, cards);
+    }
+    else
+    {
+        _cards.Assign(states, difficultyRatings, reviewDates, previousCorrectReviews, cards, header.epoch);
+        _dueAt.assign(dueAt, dueAt + cards);
+        _visit.assign(visit, visit + cards);
+    }
+
+    // -- pending cards are written earliest first, so a borrowed run is taken off the front in place, and a copy
+    // -- is already a heap. indexes in a borrowed run are checked as the cards come due instead of up front...
+    if (borrow)
+    {
+        _pendingRun = pending;
+        _pendingRunEnd = pending + header.pendingCount;
+    }
+    else
+    {
+        _pending.resize(header.pendingCount);
+
+        for (PendingCard& card : _pending)
+        {
+            card.first = pending->dueAt;
+            card.second = pending->card;
+            pending++;
+
+            if (card.second >= cards)
+            {
+                Reset();
+                return false;
+            }
+        }
+    }
+
+    if (!LoadQueue(_wrong, data + layout.wrong, header.wrongCount) ||
+        !LoadQueue(_dueNew, data + layout.dueNew, header.dueNewCount) ||
+        !LoadQueue(_dueExisting, data + layout.dueExisting, header.dueExistingCount))
+    {
+        Reset();
+        return false;
+    }
+
+    _newCardsReturned = header.newCardsReturned;
+    _existingCardsReturned = header.existingCardsReturned;
+    _currentIndex = header.currentIndex;
+    _reviewSequence = header.reviewSequence;
+    RankExisting();
+
+    return true;
+}
+
+// -- indexes are stored ascending, so each insert goes straight to the end of the set...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::LoadQueue(std::pmr::set<uint>& queue, const uint8_t* section, uint count)
+{
+    const uint32_t* indexes = reinterpret_cast<const uint32_t*>(section);
+
+    for (uint j = 0; j < count; j++)
+    {
+        if (indexes[j] >= _cards.Size())
+        {
+            return false;
+        }
+
+        queue.insert(queue.end(), indexes[j]);
+    }
+
+    return true;
+}
+
+// -- every answer from here on is appended to reviewLog, or to nothing when it is null...
+// -- an empty log is numbered from the current answer count, so it lines up with the next snapshot.
+template <typename Strategy>
+void BasicStudySession<Strategy>::SetReviewLog(ReviewLog* reviewLog)
+{
+    _reviewLog = reviewLog;
+
+    if (_reviewLog != nullptr && _reviewLog->Size() == 0)
+    {
+        _reviewLog->Truncate(_reviewSequence);
+    }
+}
+
+// -- apply the logged answers this session hasn't seen yet, in order, without logging them again...
+// -- returns how many were applied, stopping at the first one that doesn't fit the deck.
+template <typename Strategy>
+uint BasicStudySession<Strategy>::ReplayReviewLog(const ReviewLog& reviewLog)
+{
+    const std::vector<ReviewEvent>& events = reviewLog.Events();
+
+    // -- a gap between what this session has and where the log starts can't be replayed over...
+    if (reviewLog.FirstSequence() > _reviewSequence)
+    {
+        return 0;
+    }
+
+    ReviewLog* const attached = _reviewLog;
+    _reviewLog = nullptr;
+
+    uint applied = 0;
+
+    for (size_t j = _reviewSequence - reviewLog.FirstSequence(); j < events.size(); j++)
+    {
+        const ReviewEvent& event = events[j];
+
+        if (event.card >= _cards.Size() || event.outcome > static_cast<uint8_t>(ReviewOutcome::Incorrect) ||
+            !FitDeckTime(event.reviewedAt, event.reviewedAt))
+        {
+            break;
+        }
+
+        // -- an unvisited card was answered because NextReview handed it out, so count it against the caps the same way...
+        if (_visit[event.card] == ReviewState::Unvisited)
+        {
+            if (IsNewItem(event.card))
+            {
+                _newCardsReturned++;
+            }
+            else
+            {
+                _existingCardsReturned++;
+            }
+        }
+
+        _currentIndex = (event.card + 1) % _cards.Size();
+        UpdateCard(event.card, static_cast<ReviewOutcome>(event.outcome), event.reviewedAt);
+        applied++;
+    }
+
+    _reviewLog = attached;
+
+    return applied;
+}
+
+// -- rebuild a session from its last snapshot plus the answers logged after it...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::Restore(const uint8_t* snapshot, size_t size, const ReviewLog& reviewLog)
+{
+    if (!LoadSnapshot(snapshot, size) || reviewLog.FirstSequence() > _reviewSequence)
+    {
+        return false;
+    }
+
+    const size_t logged = reviewLog.FirstSequence() + reviewLog.Size();
+    const size_t tail = (logged > _reviewSequence) ? logged - _reviewSequence : 0;
+
+    return ReplayReviewLog(reviewLog) == tail;
+}
+
+// -- fold the logged answers into a fresh snapshot file and empty the log...
+// -- the snapshot and the log are each replaced whole, the log only once the snapshot is on disk, and replay skips
+// -- answers a snapshot already holds, so a crash at any point loses nothing and applies nothing twice.
+template <typename Strategy>
+bool BasicStudySession<Strategy>::CompactReviewLog(const char* snapshotPath)
+{
+    std::vector<uint8_t> snapshot;
+    SaveSnapshot(snapshot);
+
+    if (!WriteSnapshotFile(snapshotPath, snapshot))
+    {
+        return false;
+    }
+
+    return _reviewLog == nullptr || _reviewLog->Truncate(_reviewSequence);
+}
+
+// -- rough heap footprint, for budgeting how many sessions a process keeps loaded...
+template <typename Strategy>
+size_t BasicStudySession<Strategy>::MemoryUsage() const noexcept
 {
-    const auto nextReview = _reviewStrategy.NextReview(item, now);
-    return nextReview <= now;
+    // -- a red-black tree node is three pointers and a color on top of the value...
+    constexpr size_t setNodeBytes = 3 * sizeof(void*) + 2 * sizeof(uint);
+    const size_t queued = _wrong.size() + _dueNew.size() + _dueExisting.size() + _ranked.size();
+
+    return sizeof(*this) + _cards.MemoryUsage() +
+        _dueAt.capacity() * sizeof(DeckTime) + _visit.capacity() * sizeof(ReviewState) +
+        _pending.capacity() * sizeof(PendingCard) + queued * setNodeBytes +
+        _dirty.capacity() * sizeof(uint) + _isDirty.capacity() / 8;
+}
+
+template <typename Strategy>
+void BasicStudySession<Strategy>::PushPending(DeckTime dueAt, uint i)
+{
+    _pending.emplace_back(dueAt, i);
+    std::push_heap(_pending.begin(), _pending.end(), std::greater<PendingCard>());
+}
+
+// -- take the earliest pending card if it is due by now, from the heap or the borrowed run, whichever is earlier...
+template <typename Strategy>
+bool BasicStudySession<Strategy>::PopDuePending(DeckTime now, uint& i)
+{
+    const bool heapDue = !_pending.empty() && _pending.front().first <= now;
+    const bool runDue = _pendingRun != _pendingRunEnd && _pendingRun->dueAt <= now;
+
+    if (runDue && (!heapDue || PendingCard(_pendingRun->dueAt, _pendingRun->card) < _pending.front()))
+    {
+        i = _pendingRun->card;
+        _pendingRun++;
+        return true;
+    }
+
+    if (!heapDue)
+    {
+        return false;
+    }
+
+    i = _pending.front().second;
+    std::pop_heap(_pending.begin(), _pending.end(), std::greater<PendingCard>());
+    _pending.pop_back();
+
+    return true;
 }
 
-bool StudySession::IsNewItem(const ReviewItem& item) const noexcept
+// -- move what is left of a borrowed run into the heap, for changes that have to touch every pending card...
+template <typename Strategy>
+void BasicStudySession<Strategy>::MergePendingRun()
 {
-    return item.index() == 0;
+    for (; _pendingRun != _pendingRunEnd; _pendingRun++)
+    {
+        if (_pendingRun->card < _cards.Size())
+        {
+            PushPending(_pendingRun->dueAt, _pendingRun->card);
+        }
+    }
+
+    _pendingRun = nullptr;
+    _pendingRunEnd = nullptr;
 }
+
+// -- move unvisited cards whose time has come into the ready queues, returns how many heap entries it popped...
+template <typename Strategy>
+uint BasicStudySession<Strategy>::PromoteDueCards(DeckTime now)
+{
+    uint popped = 0;
+
+    uint i = 0;
+
+    while (PopDuePending(now, i))
+    {
+        popped++;
+
+        // -- answered cards are dropped lazily instead of searched for in the heap,
+        // -- and so are indexes past the deck, which only a damaged snapshot's run could hold...
+        if (i >= _visit.size() || _visit[i] != ReviewState::Unvisited)
+        {
+            continue;
+        }
+
+        if (IsNewItem(i))
+        {
+            _dueNew.insert(i);
+        }
+        else
+        {
+            QueueExisting(i);
+        }
+    }
+
+    return popped;
+}
+
+// -- first index at or after the current index, wrapping around to the front...
+template <typename Strategy>
+std::optional<uint> BasicStudySession<Strategy>::NextInRoundRobin(const std::pmr::set<uint>& queue) const
+{
+    if (queue.empty())
+    {
+        return std::nullopt;
+    }
+
+    auto it = queue.lower_bound(_currentIndex);
+
+    return (it != queue.end()) ? *it : *queue.begin();
+}
+
+// -- the round robin's pick, or the top of the ranking under any other order...
+template <typename Strategy>
+std::optional<uint> BasicStudySession<Strategy>::NextExisting() const
+{
+    if (_order == ReviewOrder::RoundRobin)
+    {
+        return NextInRoundRobin(_dueExisting);
+    }
+
+    if (_ranked.empty())
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<uint>(*_ranked.begin() & UINT32_MAX);
+}
+
+// -- lower ranks first, with the card index in the low half so ties go in storage order. a queued card's
+// -- due time, rating and review date don't change until it is answered, so its rank stays put...
+template <typename Strategy>
+uint64_t BasicStudySession<Strategy>::RankOf(uint i) const
+{
+    uint rank = 0;
+
+    switch (_order)
+    {
+    case ReviewOrder::MostOverdue:
+    {
+        rank = _dueAt[i];
+        break;
+    }
+    case ReviewOrder::HardestFirst:
+    {
+        rank = DifficultyRatingMostDifficult - std::min(_cards.Difficulty(i), DifficultyRatingMostDifficult);
+        break;
+    }
+    case ReviewOrder::ShortestInterval:
+    {
+        const DeckTime reviewDate = _cards.ReviewDates()[i];
+        rank = (_dueAt[i] > reviewDate) ? _dueAt[i] - reviewDate : 0;
+        break;
+    }
+    case ReviewOrder::RoundRobin:
+    default:
+        break;
+    }
+
+    return (static_cast<uint64_t>(rank) << 32) | i;
+}
+
+template <typename Strategy>
+void BasicStudySession<Strategy>::QueueExisting(uint i)
+{
+    if (_dueExisting.insert(i).second && _order != ReviewOrder::RoundRobin)
+    {
+        _ranked.insert(RankOf(i));
+    }
+}
+
+template <typename Strategy>
+void BasicStudySession<Strategy>::UnqueueExisting(uint i)
+{
+    if (_dueExisting.erase(i) != 0 && _order != ReviewOrder::RoundRobin)
+    {
+        _ranked.erase(RankOf(i));
+    }
+}
+
+template <typename Strategy>
+void BasicStudySession<Strategy>::RankExisting()
+{
+    _ranked.clear();
+
+    if (_order == ReviewOrder::RoundRobin)
+    {
+        return;
+    }
+
+    for (const uint i : _dueExisting)
+    {
+        _ranked.insert(RankOf(i));
+    }
+}
+
+// -- takes effect from the next card on, for cards already waiting as well...
+template <typename Strategy>
+void BasicStudySession<Strategy>::SetReviewOrder(ReviewOrder order)
+{
+    _order = order;
+
+    RankExisting();
+}
+
+// -- recompute every cached due time and requeue the cards still waiting to be seen...
+template <typename Strategy>
+void BasicStudySession<Strategy>::RebuildDueTimes()
+{
+    _pending.clear();
+    _pendingRun = nullptr;
+    _pendingRunEnd = nullptr;
+    _dueNew.clear();
+    _dueExisting.clear();
+    _ranked.clear();
+
+    _reviewStrategy->NextReviewColumns(_cards, 0, _cards.Size(), DueImmediately, _dueAt.MutableData());
+
+    for (uint i = 0; i < _cards.Size(); i++)
+    {
+        if (_visit[i] == ReviewState::Unvisited)
+        {
+            _pending.emplace_back(_dueAt[i], i);
+        }
+    }
+
+    std::make_heap(_pending.begin(), _pending.end(), std::greater<PendingCard>());
+}
+
+// -- the polymorphic session used by the tests, and the SM-2 one the app runs on...
+template class jlimdev::BasicStudySession<IReviewStrategy>;
+template class jlimdev::BasicStudySession<SuperMemo2ReviewStrategy>;
@@ -3,20 +3,53 @@
 #include <vector>
 #include <optional>
 #include <variant>
+#include <set>
+#include <memory_resource>
+#include <algorithm>
+#include <functional>
+#include <utility>
 
 namespace jlimdev {
 
-    enum class ReviewState
+    enum class ReviewState : uint8_t
     {
         Unvisited,
         Visited,
         Wrong
     };
 
-    class StudySession
+    // -- which due existing card NextReview hands out first; new and wrong cards always go round robin...
+    enum class ReviewOrder : uint8_t
     {
+        // -- storage order, carrying on from the last card handed out...
+        RoundRobin,
+        // -- earliest due time first...
+        MostOverdue,
+        // -- highest difficultyRating first...
+        HardestFirst,
+        // -- shortest time between the last review and the due time first...
+        ShortestInterval
+    };
+
+    /// <summary>
+    /// A study session over one deck. Strategy is either IReviewStrategy, for a strategy picked at runtime,
+    /// or a final strategy class, so the compiler can call it directly instead of through the vtable.
+    /// All of its storage comes from a per-session pool on top of the memory resource it is given, so
+    /// Reset hands queue nodes back to the pool instead of the heap, and a reset session refills
+    /// without allocating as long as the next deck is no bigger.
+    /// </summary>
+    template <typename Strategy>
+    class BasicStudySession
+    {
+    public:
+        // -- imports the next chunk of a streamed deck into the session, false when the deck has no more to give...
+        using ChunkLoader = std::function<bool(BasicStudySession& session)>;
+
     private:
-        const IReviewStrategy& _reviewStrategy;
+        const Strategy* _reviewStrategy;
+
+        // -- declared first, so it outlives every container allocating from it...
+        std::pmr::unsynchronized_pool_resource _arena;
 
         uint _newCardsReturned;
         uint _existingCardsReturned;
@@ -24,27 +57,112 @@ namespace jlimdev {
         uint _existingCardMax;
         uint _cardLimit;
 
-        std::vector<ReviewItem> _cards;
-        std::vector<ReviewState> _visit;
+        CardStore _cards;
+        // -- due time the strategy gave each card, in the store's deck time, so scheduling queries don't recompute it...
+        Column<DeckTime> _dueAt;
+        Column<ReviewState> _visit;
         uint _currentIndex;
 
+        // -- due-queue index so NextReview doesn't rescan the whole deck on every call...
+        // -- unvisited cards wait in the _pending min-heap (earliest due first) until their time comes,
+        // -- then move into the ready queues, which are ordered by index for the round robin.
+        using PendingCard = std::pair<DeckTime, uint>;
+        std::pmr::vector<PendingCard> _pending;
+        // -- pending cards still sitting in a borrowed snapshot, earliest first, taken from the front alongside the heap...
+        const SnapshotPending* _pendingRun;
+        const SnapshotPending* _pendingRunEnd;
+        std::pmr::set<uint> _wrong;
+        std::pmr::set<uint> _dueNew;
+        std::pmr::set<uint> _dueExisting;
+
+        // -- _dueExisting again, ordered by rank then index, whenever the order isn't round robin...
+        ReviewOrder _order;
+        std::pmr::set<uint64_t> _ranked;
+
+        // -- cards changed since the last commit, as a list for exporting and a bitmap to keep it free of repeats...
+        std::pmr::vector<uint> _dirty;
+        std::pmr::vector<bool> _isDirty;
+
+        // -- answers given over the deck's lifetime, and where to log each one as it comes in...
+        uint _reviewSequence;
+        ReviewLog* _reviewLog;
+
+        // -- streaming load: how many cards the deck holds once every chunk is in, and where to get the next chunk...
+        uint _streamTotal;
+        ChunkLoader _loader;
+
     public:
-        StudySession(const IReviewStrategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit) noexcept;
-        void AddNeverReviewed();
-        void AddPreviouslyIncorrect(uint difficultyRating, Timestamp reviewDate);
-        void AddPreviouslyFirstCorrect(uint difficultyRating, Timestamp reviewDate);
-        void AddPreviouslyCorrect(uint difficultyRating, Timestamp reviewDate, Timestamp previousCorrectReview);
-        uint UpdateCard(uint i, const ReviewOutcome& outcome, uint now);
-        const ReviewItem& At(uint i) const;
+        BasicStudySession(const Strategy& reviewStrategy, uint maxNewCard, uint maxExistingCard, uint cardLimit,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+        BasicStudySession(const BasicStudySession&) = delete;
+        BasicStudySession& operator=(const BasicStudySession&) = delete;
+        bool AddNeverReviewed();
+        bool AddPreviouslyIncorrect(uint difficultyRating, Timestamp reviewDate);
+        bool AddPreviouslyFirstCorrect(uint difficultyRating, Timestamp reviewDate);
+        bool AddPreviouslyCorrect(uint difficultyRating, Timestamp reviewDate, Timestamp previousCorrectReview);
+        std::optional<Timestamp> UpdateCard(uint i, const ReviewOutcome& outcome, Timestamp now);
+        ReviewItem At(uint i) const;
         std::optional<uint> NextReview(Timestamp now);
-        void AddItem(const ReviewItem& item);
-        uint GetNextReviewTime(uint i, uint now) const;
+        bool PromoteCard(uint i, Timestamp now);
+        bool AddItem(const ReviewItem& item);
+        void Reserve(uint count);
+        uint ImportRecords(const DeckRecord* records, uint count);
+        void StreamDeck(uint totalCards, ChunkLoader loader = nullptr);
+        bool LoadNextChunk();
+        bool FullyLoaded() const noexcept { return _cards.Size() >= _streamTotal; }
+        uint StreamedSize() const noexcept { return std::max(_streamTotal, _cards.Size()); }
+        void ExportRecords(Timestamp now, ExportedRecord* out) const;
+        void ExportDirtyRecords(Timestamp now, ExportedRecord* out) const;
+        const std::pmr::vector<uint>& DirtyCards() const noexcept { return _dirty; }
+        void CommitDirtyCards() noexcept;
+        uint Size() const noexcept { return _cards.Size(); }
+        void SaveSnapshot(std::vector<uint8_t>& out) const;
+        bool LoadSnapshot(const uint8_t* data, size_t size);
+        bool BorrowSnapshot(const uint8_t* data, size_t size);
+        void SetReviewLog(ReviewLog* reviewLog);
+        uint ReplayReviewLog(const ReviewLog& reviewLog);
+        bool Restore(const uint8_t* snapshot, size_t size, const ReviewLog& reviewLog);
+        bool CompactReviewLog(const char* snapshotPath);
+        uint ReviewSequence() const noexcept { return _reviewSequence; }
+        size_t MemoryUsage() const noexcept;
+        Timestamp GetNextReviewTime(uint i, Timestamp now) const;
+        void GetNextReviewTimes(Timestamp now, Timestamp* out) const;
+        void ForecastDueCounts(Timestamp now, uint days, uint* counts, uint threads = 0) const;
         void Reset();
+        void SetReviewStrategy(const Strategy& reviewStrategy);
+        void SetReviewOrder(ReviewOrder order);
+        ReviewOrder Order() const noexcept { return _order; }
+        // -- caps can move during a session, cards already handed out stay counted...
+        void SetCardCaps(uint maxNewCard, uint maxExistingCard) noexcept { _newCardMax = maxNewCard; _existingCardMax = maxExistingCard; }
+        uint NewCardsReturned() const noexcept { return _newCardsReturned; }
+        uint ExistingCardsReturned() const noexcept { return _existingCardsReturned; }
     private:
         ReviewItem MapItem(uint i, const ReviewOutcome& outcome, Timestamp now);
-        bool IsDue(const ReviewItem& item, const Timestamp& now) const;
-        bool IsNewItem(const ReviewItem& item) const noexcept;
+        bool IsDue(uint i, DeckTime now) const;
+        bool IsNewItem(uint i) const;
+        DeckTime DueAt(const ReviewItem& item) const;
+        bool FitDeckTime(Timestamp earliest, Timestamp latest);
+        void PushPending(DeckTime dueAt, uint i);
+        bool PopDuePending(DeckTime now, uint& i);
+        void MergePendingRun();
+        void MarkDirty(uint i);
+        ExportedRecord ExportRecord(uint i, Timestamp now) const;
+        uint PromoteDueCards(DeckTime now);
+        void RebuildDueTimes();
+        std::optional<uint> NextInRoundRobin(const std::pmr::set<uint>& queue) const;
+        std::optional<uint> NextExisting() const;
+        uint64_t RankOf(uint i) const;
+        void QueueExisting(uint i);
+        void UnqueueExisting(uint i);
+        void RankExisting();
+        bool ReadSnapshot(const uint8_t* data, size_t size, bool borrow);
+        bool LoadQueue(std::pmr::set<uint>& queue, const uint8_t* section, uint count);
     };
 
+    // -- both are explicitly instantiated in StudySession.cpp...
+    extern template class BasicStudySession<IReviewStrategy>;
+    extern template class BasicStudySession<SuperMemo2ReviewStrategy>;
 
+    using StudySession = BasicStudySession<IReviewStrategy>;
+    using SuperMemo2StudySession = BasicStudySession<SuperMemo2ReviewStrategy>;
 }
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "Dejavu.h"
+#include "SuperMemo2Tables.h"
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define DEJAVU_KERNEL_WASM_SIMD 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DEJAVU_KERNEL_SSE2 1
+#endif
+
+using namespace jlimdev;
+
+// -- four deck times per step, each lane doing exactly what NextReviewSuperMemo2Visitor does for a PreviouslyCorrect card:
+// --     easinessFactor = EasinessFactorTable[difficultyRating]
+// --     days = uint(reviewDate - previousCorrectReview) / 86400
+// --     next = reviewDate + uint(int((days - 1) * easinessFactor)) * 86400
+// -- with the same uint wraparound in the interval, so results match the scalar visitor bit for bit. the sum is
+// -- held at DeckTimeMax instead of wrapping, the same as CardStore::ToDeckTime does with the visitor's result.
+
+constexpr double secondsPerDay = 24 * 60 * 60;
+
+static double EasinessFactor(uint8_t difficultyRating) noexcept
+{
+    return EasinessFactorTable[std::min<uint>(difficultyRating, DifficultyRatingMostDifficult)];
+}
+
+#if DEJAVU_KERNEL_SSE2
+
+// -- SSE2 only converts signed ints, so bias unsigned lanes into signed range and add the bias back...
+static __m128d ConvertLowUnsigned(__m128i v) noexcept
+{
+    const __m128i signedV = _mm_xor_si128(v, _mm_set1_epi32(INT32_MIN));
+
+    return _mm_add_pd(_mm_cvtepi32_pd(signedV), _mm_set1_pd(2147483648.0));
+}
+
+static __m128d ConvertHighUnsigned(__m128i v) noexcept
+{
+    return ConvertLowUnsigned(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+// -- SSE2 has no 32-bit lane multiply, so multiply even and odd lanes as 64-bit and take the low halves...
+static __m128i MultiplyLow32(__m128i a, __m128i b) noexcept
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static size_t NextReviewPreviouslyCorrectVector(const uint8_t* difficultyRating, const DeckTime* reviewDate,
+    const DeckTime* previousCorrectReview, size_t count, DeckTime* out) noexcept
+{
+    const __m128d day = _mm_set1_pd(secondsPerDay);
+    const __m128i daySeconds = _mm_set1_epi32(24 * 60 * 60);
+    const __m128i one = _mm_set1_epi32(1);
+
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i review = _mm_loadu_si128(reinterpret_cast<const __m128i*>(reviewDate + i));
+        const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previousCorrectReview + i));
+        const __m128i seconds = _mm_sub_epi32(review, previous);
+
+        // -- quotients are below 2^16, so truncating the double quotient is the exact integer division...
+        const __m128i daysLow = _mm_cvttpd_epi32(_mm_div_pd(ConvertLowUnsigned(seconds), day));
+        const __m128i daysHigh = _mm_cvttpd_epi32(_mm_div_pd(ConvertHighUnsigned(seconds), day));
+        const __m128i daysSincePreviousReview = _mm_unpacklo_epi64(daysLow, daysHigh);
+        const __m128i daysMinusOne = _mm_sub_epi32(daysSincePreviousReview, one);
+
+        const __m128d easinessLow = _mm_set_pd(EasinessFactor(difficultyRating[i + 1]), EasinessFactor(difficultyRating[i]));
+        const __m128d easinessHigh = _mm_set_pd(EasinessFactor(difficultyRating[i + 3]), EasinessFactor(difficultyRating[i + 2]));
+
+        const __m128i untilLow = _mm_cvttpd_epi32(_mm_mul_pd(ConvertLowUnsigned(daysMinusOne), easinessLow));
+        const __m128i untilHigh = _mm_cvttpd_epi32(_mm_mul_pd(ConvertHighUnsigned(daysMinusOne), easinessHigh));
+        const __m128i daysUntilNextReview = _mm_unpacklo_epi64(untilLow, untilHigh);
+
+        const __m128i next = _mm_add_epi32(review, MultiplyLow32(daysUntilNextReview, daySeconds));
+
+        // -- a lane that wrapped came out below its review date; unsigned compare by biasing both into signed range...
+        const __m128i bias = _mm_set1_epi32(INT32_MIN);
+        const __m128i wrapped = _mm_cmpgt_epi32(_mm_xor_si128(review, bias), _mm_xor_si128(next, bias));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(next, wrapped));
+    }
+
+    return i;
+}
+
+#elif DEJAVU_KERNEL_WASM_SIMD
+
+static size_t NextReviewPreviouslyCorrectVector(const uint8_t* difficultyRating, const DeckTime* reviewDate,
+    const DeckTime* previousCorrectReview, size_t count, DeckTime* out) noexcept
+{
+    const v128_t day = wasm_f64x2_splat(secondsPerDay);
+    const v128_t daySeconds = wasm_i32x4_splat(24 * 60 * 60);
+    const v128_t one = wasm_i32x4_splat(1);
+
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const v128_t review = wasm_v128_load(reviewDate + i);
+        const v128_t previous = wasm_v128_load(previousCorrectReview + i);
+        const v128_t seconds = wasm_i32x4_sub(review, previous);
+        const v128_t secondsHigh = wasm_i32x4_shuffle(seconds, seconds, 2, 3, 0, 1);
+
+        // -- quotients are below 2^16, so truncating the double quotient is the exact integer division...
+        const v128_t daysLow = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_div(wasm_f64x2_convert_low_u32x4(seconds), day));
+        const v128_t daysHigh = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_div(wasm_f64x2_convert_low_u32x4(secondsHigh), day));
+        const v128_t daysMinusOne = wasm_i32x4_sub(wasm_i32x4_shuffle(daysLow, daysHigh, 0, 1, 4, 5), one);
+        const v128_t daysMinusOneHigh = wasm_i32x4_shuffle(daysMinusOne, daysMinusOne, 2, 3, 0, 1);
+
+        const v128_t easinessLow = wasm_f64x2_make(EasinessFactor(difficultyRating[i]), EasinessFactor(difficultyRating[i + 1]));
+        const v128_t easinessHigh = wasm_f64x2_make(EasinessFactor(difficultyRating[i + 2]), EasinessFactor(difficultyRating[i + 3]));
+
+        const v128_t untilLow = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_mul(wasm_f64x2_convert_low_u32x4(daysMinusOne), easinessLow));
+        const v128_t untilHigh = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_mul(wasm_f64x2_convert_low_u32x4(daysMinusOneHigh), easinessHigh));
+        const v128_t daysUntilNextReview = wasm_i32x4_shuffle(untilLow, untilHigh, 0, 1, 4, 5);
+
+        const v128_t next = wasm_i32x4_add(review, wasm_i32x4_mul(daysUntilNextReview, daySeconds));
+
+        // -- a lane that wrapped came out below its review date...
+        wasm_v128_store(out + i, wasm_v128_or(next, wasm_u32x4_lt(next, review)));
+    }
+
+    return i;
+}
+
+#else
+
+static size_t NextReviewPreviouslyCorrectVector(const uint8_t*, const DeckTime*, const DeckTime*, size_t, DeckTime*) noexcept
+{
+    return 0;
+}
+
+#endif
+
+void SuperMemo2ReviewStrategy::NextReviewPreviouslyCorrect(const uint8_t* difficultyRating, const DeckTime* reviewDate,
+    const DeckTime* previousCorrectReview, size_t count, DeckTime* out) noexcept
+{
+    size_t i = NextReviewPreviouslyCorrectVector(difficultyRating, reviewDate, previousCorrectReview, count, out);
+
+    // -- scalar fallback for the tail, or everything when there's no SIMD...
+    for (; i < count; i++)
+    {
+        const double easinessFactor = EasinessFactor(difficultyRating[i]);
+        const uint seconds = reviewDate[i] - previousCorrectReview[i];
+        const uint daysSincePreviousReview = seconds / (24 * 60 * 60);
+        const uint daysUntilNextReview = static_cast<int>((daysSincePreviousReview - 1) * easinessFactor);
+        const DeckTime next = reviewDate[i] + daysUntilNextReview * 24 * 60 * 60;
+
+        out[i] = (next < reviewDate[i]) ? DeckTimeMax : next;
+    }
+}
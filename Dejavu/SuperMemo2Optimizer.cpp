@@ -0,0 +1,408 @@
+#include "Dejavu.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define DEJAVU_LOSS_WASM_SIMD 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DEJAVU_LOSS_SSE2 1
+#endif
+
+using namespace jlimdev;
+
+constexpr double secondsPerDay = 24 * 60 * 60;
+// -- recall predicted once a whole scheduled interval has passed...
+constexpr double targetRetention = 0.9;
+
+void ReviewHistories::AddAnswer(ReviewOutcome reviewOutcome, Timestamp sincePreviousAnswer)
+{
+    outcome.push_back(static_cast<uint8_t>(reviewOutcome));
+    elapsed.push_back(sincePreviousAnswer);
+}
+
+void ReviewHistories::EndCard()
+{
+    cardStart.push_back(static_cast<uint32_t>(outcome.size()));
+}
+
+ReviewHistories jlimdev::HistoriesFromReviewLog(const std::vector<ReviewEvent>& events)
+{
+    std::unordered_map<uint, std::vector<size_t>> byCard;
+    std::vector<uint> cards;
+
+    for (size_t j = 0; j < events.size(); j++)
+    {
+        std::vector<size_t>& answers = byCard[events[j].card];
+
+        if (answers.empty())
+        {
+            cards.push_back(events[j].card);
+        }
+
+        answers.push_back(j);
+    }
+
+    std::sort(cards.begin(), cards.end());
+
+    ReviewHistories histories;
+
+    for (const uint card : cards)
+    {
+        Timestamp previous = 0;
+
+        for (const size_t j : byCard[card])
+        {
+            const Timestamp reviewedAt = events[j].reviewedAt;
+
+            histories.AddAnswer(static_cast<ReviewOutcome>(events[j].outcome), (previous == 0) ? 0 : reviewedAt - previous);
+            previous = reviewedAt;
+        }
+
+        histories.EndCard();
+    }
+
+    return histories;
+}
+
+// -- the scored answers of one replay, as columns...
+struct Predictions
+{
+    std::vector<double> elapsedDays;
+    std::vector<double> intervalDays;
+    std::vector<double> recalled;
+
+    void Clear()
+    {
+        elapsedDays.clear();
+        intervalDays.clear();
+        recalled.clear();
+    }
+};
+
+// -- walk every card through its answers the way StudySession::UpdateCard would, noting the interval
+// -- the strategy had scheduled before each answer that followed a correct one...
+static void Replay(const ParameterizedSuperMemo2ReviewStrategy& strategy, const ReviewHistories& histories, Predictions& predictions)
+{
+    predictions.Clear();
+
+    for (size_t card = 0; card < histories.Cards(); card++)
+    {
+        ReviewItem item = NeverReviewed{ DifficultyRatingMostDifficult };
+        Timestamp now = 0;
+
+        for (uint32_t j = histories.cardStart[card]; j < histories.cardStart[card + 1]; j++)
+        {
+            const ReviewOutcome outcome = static_cast<ReviewOutcome>(histories.outcome[j]);
+            const bool correct = outcome != ReviewOutcome::Incorrect;
+            const Timestamp reviewDate = now;
+
+            now += histories.elapsed[j];
+
+            if (std::holds_alternative<PreviouslyFirstCorrect>(item) || std::holds_alternative<PreviouslyCorrect>(item))
+            {
+                // -- a day at the least, SM-2 can schedule a card for the day it was answered...
+                const int32_t interval = static_cast<int32_t>(strategy.NextReview(item, now) - reviewDate);
+
+                predictions.elapsedDays.push_back(histories.elapsed[j] / secondsPerDay);
+                predictions.intervalDays.push_back(std::max(interval / secondsPerDay, 1.0));
+                predictions.recalled.push_back(correct ? 1.0 : 0.0);
+            }
+
+            const DifficultyRating difficultyRating = strategy.AdjustDifficulty(item, outcome);
+
+            if (!correct)
+            {
+                item = PreviouslyIncorrect{ difficultyRating, now };
+            }
+            else if (const PreviouslyFirstCorrect* first = std::get_if<PreviouslyFirstCorrect>(&item))
+            {
+                item = PreviouslyCorrect{ difficultyRating, now, first->reviewDate };
+            }
+            else if (const PreviouslyCorrect* previous = std::get_if<PreviouslyCorrect>(&item))
+            {
+                item = PreviouslyCorrect{ difficultyRating, now, previous->reviewDate };
+            }
+            else
+            {
+                item = PreviouslyFirstCorrect{ difficultyRating, now };
+            }
+        }
+    }
+}
+
+// -- recall = 0.9 ^ (elapsed / interval) = 2 ^ x, with x = log2(0.9) * elapsed / interval never above zero.
+// -- 2 ^ x is split into 2 ^ n, built straight into the exponent bits, times e ^ (f ln 2) for f in [-0.5, 0.5],
+// -- from a degree 8 Taylor polynomial, good to about 1e-10. the vector and scalar paths do exactly the same
+// -- operations in the same order, so the loss comes out bit for bit the same however the columns are split.
+
+constexpr double ln2 = 0.6931471805599453;
+// -- past this recall is 0 to well within the polynomial's error, and 2 ^ n is still a normal double...
+constexpr double smallestExponent = -1000;
+
+constexpr double exp2Coefficients[] = {
+    1.0 / 40320, 1.0 / 5040, 1.0 / 720, 1.0 / 120, 1.0 / 24, 1.0 / 6, 1.0 / 2, 1.0, 1.0 };
+
+static double Exp2NonPositive(double x) noexcept
+{
+    x = std::max(x, smallestExponent);
+
+    // -- x - 0.5 is negative, so truncating rounds x to the nearest whole number...
+    const int32_t n = static_cast<int32_t>(x - 0.5);
+    const double y = (x - n) * ln2;
+
+    double polynomial = exp2Coefficients[0];
+
+    for (size_t k = 1; k < std::size(exp2Coefficients); k++)
+    {
+        polynomial = polynomial * y + exp2Coefficients[k];
+    }
+
+    const uint64_t bits = static_cast<uint64_t>(n + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+
+    return polynomial * scale;
+}
+
+#if DEJAVU_LOSS_SSE2
+
+static __m128d Exp2NonPositive(__m128d x) noexcept
+{
+    x = _mm_max_pd(x, _mm_set1_pd(smallestExponent));
+
+    const __m128i n = _mm_cvttpd_epi32(_mm_sub_pd(x, _mm_set1_pd(0.5)));
+    const __m128d y = _mm_mul_pd(_mm_sub_pd(x, _mm_cvtepi32_pd(n)), _mm_set1_pd(ln2));
+
+    __m128d polynomial = _mm_set1_pd(exp2Coefficients[0]);
+
+    for (size_t k = 1; k < std::size(exp2Coefficients); k++)
+    {
+        polynomial = _mm_add_pd(_mm_mul_pd(polynomial, y), _mm_set1_pd(exp2Coefficients[k]));
+    }
+
+    // -- biased exponents are positive, so widening the two low lanes with zeros is enough...
+    const __m128i biased = _mm_unpacklo_epi32(_mm_add_epi32(n, _mm_set1_epi32(1023)), _mm_setzero_si128());
+
+    return _mm_mul_pd(polynomial, _mm_castsi128_pd(_mm_slli_epi64(biased, 52)));
+}
+
+static __m128d SquaredError(const double* elapsedDays, const double* intervalDays, const double* recalled, __m128d log2Retention) noexcept
+{
+    const __m128d x = _mm_div_pd(_mm_mul_pd(log2Retention, _mm_loadu_pd(elapsedDays)), _mm_loadu_pd(intervalDays));
+    const __m128d error = _mm_sub_pd(Exp2NonPositive(x), _mm_loadu_pd(recalled));
+
+    return _mm_mul_pd(error, error);
+}
+
+// -- two pairs of lanes, each lane summing every fourth answer just as the scalar loop does...
+static size_t SumSquaredErrorsVector(const double* elapsedDays, const double* intervalDays, const double* recalled,
+    size_t count, double log2Retention, double* sum) noexcept
+{
+    const __m128d retention = _mm_set1_pd(log2Retention);
+    __m128d low = _mm_setzero_pd();
+    __m128d high = _mm_setzero_pd();
+
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        low = _mm_add_pd(low, SquaredError(elapsedDays + i, intervalDays + i, recalled + i, retention));
+        high = _mm_add_pd(high, SquaredError(elapsedDays + i + 2, intervalDays + i + 2, recalled + i + 2, retention));
+    }
+
+    _mm_storeu_pd(sum, low);
+    _mm_storeu_pd(sum + 2, high);
+
+    return i;
+}
+
+#elif DEJAVU_LOSS_WASM_SIMD
+
+static v128_t Exp2NonPositive(v128_t x) noexcept
+{
+    x = wasm_f64x2_max(x, wasm_f64x2_splat(smallestExponent));
+
+    const v128_t n = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_sub(x, wasm_f64x2_splat(0.5)));
+    const v128_t y = wasm_f64x2_mul(wasm_f64x2_sub(x, wasm_f64x2_convert_low_i32x4(n)), wasm_f64x2_splat(ln2));
+
+    v128_t polynomial = wasm_f64x2_splat(exp2Coefficients[0]);
+
+    for (size_t k = 1; k < std::size(exp2Coefficients); k++)
+    {
+        polynomial = wasm_f64x2_add(wasm_f64x2_mul(polynomial, y), wasm_f64x2_splat(exp2Coefficients[k]));
+    }
+
+    const v128_t biased = wasm_u64x2_extend_low_u32x4(wasm_i32x4_add(n, wasm_i32x4_splat(1023)));
+
+    return wasm_f64x2_mul(polynomial, wasm_i64x2_shl(biased, 52));
+}
+
+static v128_t SquaredError(const double* elapsedDays, const double* intervalDays, const double* recalled, v128_t log2Retention) noexcept
+{
+    const v128_t x = wasm_f64x2_div(wasm_f64x2_mul(log2Retention, wasm_v128_load(elapsedDays)), wasm_v128_load(intervalDays));
+    const v128_t error = wasm_f64x2_sub(Exp2NonPositive(x), wasm_v128_load(recalled));
+
+    return wasm_f64x2_mul(error, error);
+}
+
+static size_t SumSquaredErrorsVector(const double* elapsedDays, const double* intervalDays, const double* recalled,
+    size_t count, double log2Retention, double* sum) noexcept
+{
+    const v128_t retention = wasm_f64x2_splat(log2Retention);
+    v128_t low = wasm_f64x2_splat(0.0);
+    v128_t high = wasm_f64x2_splat(0.0);
+
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        low = wasm_f64x2_add(low, SquaredError(elapsedDays + i, intervalDays + i, recalled + i, retention));
+        high = wasm_f64x2_add(high, SquaredError(elapsedDays + i + 2, intervalDays + i + 2, recalled + i + 2, retention));
+    }
+
+    wasm_v128_store(sum, low);
+    wasm_v128_store(sum + 2, high);
+
+    return i;
+}
+
+#else
+
+static size_t SumSquaredErrorsVector(const double*, const double*, const double*, size_t, double, double*) noexcept
+{
+    return 0;
+}
+
+#endif
+
+static double BrierScore(const Predictions& predictions) noexcept
+{
+    const double log2Retention = std::log2(targetRetention);
+    const size_t count = predictions.recalled.size();
+    const double* elapsedDays = predictions.elapsedDays.data();
+    const double* intervalDays = predictions.intervalDays.data();
+    const double* recalled = predictions.recalled.data();
+
+    double sum[4] = { 0, 0, 0, 0 };
+    size_t i = SumSquaredErrorsVector(elapsedDays, intervalDays, recalled, count, log2Retention, sum);
+
+    // -- scalar fallback for the tail, or everything when there's no SIMD...
+    for (; i + 4 <= count; i += 4)
+    {
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            const double error = Exp2NonPositive(log2Retention * elapsedDays[i + lane] / intervalDays[i + lane]) - recalled[i + lane];
+
+            sum[lane] += error * error;
+        }
+    }
+
+    for (; i < count; i++)
+    {
+        const double error = Exp2NonPositive(log2Retention * elapsedDays[i] / intervalDays[i]) - recalled[i];
+
+        sum[0] += error * error;
+    }
+
+    return (count == 0) ? 0.0 : (sum[0] + sum[1] + sum[2] + sum[3]) / count;
+}
+
+static double Loss(const SuperMemo2Parameters& parameters, const ReviewHistories& histories, Predictions& scratch)
+{
+    Replay(ParameterizedSuperMemo2ReviewStrategy(parameters), histories, scratch);
+
+    return BrierScore(scratch);
+}
+
+double jlimdev::SuperMemo2Loss(const SuperMemo2Parameters& parameters, const ReviewHistories& histories)
+{
+    Predictions scratch;
+
+    return Loss(parameters, histories, scratch);
+}
+
+// -- keep candidates to parameters SM-2 makes sense with: easiness falling with difficulty and never under 1.3 at the easiest...
+static SuperMemo2Parameters Perturb(const SuperMemo2Parameters& best, double step, std::mt19937& random)
+{
+    std::normal_distribution<double> noise(0.0, step);
+    SuperMemo2Parameters candidate = best;
+
+    candidate.easinessIntercept = std::clamp(best.easinessIntercept * (1 + noise(random)), 1.3, 5.0);
+    candidate.easinessSlope = std::clamp(best.easinessSlope * (1 + noise(random)), -0.05, -0.001);
+    candidate.updateBase = std::clamp(best.updateBase * (1 + noise(random)), 0.0, 1.0);
+    candidate.updateLinear = std::clamp(best.updateLinear * (1 + noise(random)), 0.0, 1.0);
+    candidate.updateQuadratic = std::clamp(best.updateQuadratic * (1 + noise(random)), 0.0, 1.0);
+    candidate.firstIntervalDays = std::clamp(best.firstIntervalDays * (1 + noise(random)), 1.0, 60.0);
+
+    return candidate;
+}
+
+SuperMemo2Parameters jlimdev::FitSuperMemo2Parameters(const ReviewHistories& histories, const SuperMemo2Parameters& start,
+    const SuperMemo2FitSettings& settings, double* loss)
+{
+    const uint threads = std::max((settings.threads == 0) ? std::thread::hardware_concurrency() : settings.threads, 1U);
+
+    std::mt19937 random(settings.seed);
+    std::vector<Predictions> scratch(threads);
+    std::vector<SuperMemo2Parameters> candidates(settings.candidatesPerRound);
+    std::vector<double> losses(settings.candidatesPerRound);
+
+    SuperMemo2Parameters best = start;
+    double bestLoss = Loss(best, histories, scratch[0]);
+    double step = settings.initialStep;
+
+    for (uint round = 0; round < settings.rounds; round++)
+    {
+        // -- candidates are drawn up front on this thread, so a fit is the same however many threads score it...
+        for (SuperMemo2Parameters& candidate : candidates)
+        {
+            candidate = Perturb(best, step, random);
+        }
+
+        std::atomic<size_t> next{ 0 };
+        std::vector<std::thread> pool;
+
+        for (uint t = 0; t < threads; t++)
+        {
+            pool.emplace_back([&, t]()
+            {
+                for (size_t c = next++; c < candidates.size(); c = next++)
+                {
+                    losses[c] = Loss(candidates[c], histories, scratch[t]);
+                }
+            });
+        }
+
+        for (std::thread& worker : pool)
+        {
+            worker.join();
+        }
+
+        const size_t winner = std::min_element(losses.begin(), losses.end()) - losses.begin();
+
+        if (!candidates.empty() && losses[winner] < bestLoss)
+        {
+            best = candidates[winner];
+            bestLoss = losses[winner];
+        }
+        else
+        {
+            step /= 2;
+        }
+    }
+
+    if (loss != nullptr)
+    {
+        *loss = bestLoss;
+    }
+
+    return best;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jlimdev
+{
+    /// <summary>
+    /// Recorded answers, card after card, each card's answers in the order they were given,
+    /// with the time since that card's previous answer (0 for its first). Every card is taken
+    /// to start out never reviewed, the way AddNeverReviewed adds it.
+    /// </summary>
+    struct ReviewHistories
+    {
+        std::vector<uint32_t> cardStart{ 0 };
+        std::vector<uint8_t> outcome;
+        std::vector<Timestamp> elapsed;
+
+        void AddAnswer(ReviewOutcome reviewOutcome, Timestamp sincePreviousAnswer);
+        void EndCard();
+        size_t Cards() const noexcept { return cardStart.size() - 1; }
+        size_t Answers() const noexcept { return outcome.size(); }
+    };
+
+    // -- group a review log's answers by card, e.g. to fit parameters to what learners actually did...
+    ReviewHistories HistoriesFromReviewLog(const std::vector<ReviewEvent>& events);
+
+    struct SuperMemo2FitSettings
+    {
+        uint rounds = 40;
+        uint candidatesPerRound = 64;
+        uint threads = 0;            // 0 for one per core
+        double initialStep = 0.25;   // relative size of the first perturbations, halved whenever a round finds nothing better
+        uint seed = 17;
+    };
+
+    // -- how well the parameters predict the answers: replay every history with the strategy the parameters make,
+    // -- predict recall = 0.9 ^ (time since the previous answer / interval the strategy gave), and take the mean
+    // -- squared error (Brier score) against whether the answer was right. Only answers to cards that had a scheduled
+    // -- interval, previously first correct or correct, are scored.
+    double SuperMemo2Loss(const SuperMemo2Parameters& parameters, const ReviewHistories& histories);
+
+    // -- search for the parameters with the lowest loss, starting from start: each round perturbs the best so far
+    // -- into candidatesPerRound candidates and scores them in parallel...
+    SuperMemo2Parameters FitSuperMemo2Parameters(const ReviewHistories& histories, const SuperMemo2Parameters& start,
+        const SuperMemo2FitSettings& settings, double* loss = nullptr);
+}
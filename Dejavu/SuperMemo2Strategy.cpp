@@ -1,4 +1,6 @@
 #include "Dejavu.h"
+#include "SuperMemo2Tables.h"
+#include <algorithm>
 
 using namespace jlimdev;
 
@@ -22,88 +24,133 @@ struct NextReviewSuperMemo2Visitor
     }
     Timestamp operator()(const PreviouslyCorrect& p)
     {
-        const double easinessFactor = SuperMemo2ReviewStrategy::DifficultyRatingToEasinessFactor(p.difficultyRating);
-        const Timestamp seconds = p.reviewDate - p.previousCorrectReview;
-        const Timestamp daysSincePreviousReview = seconds / (24 * 60 * 60);
-        const Timestamp daysUntilNextReview = static_cast<int>((daysSincePreviousReview - 1) * easinessFactor);
+        // -- the interval is worked out in 32 bits, the same as NextReviewPreviouslyCorrect does on deck times...
+        const double easinessFactor = EasinessFactorTable[std::min(p.difficultyRating, DifficultyRatingMostDifficult)];
+        const uint seconds = static_cast<uint>(p.reviewDate - p.previousCorrectReview);
+        const uint daysSincePreviousReview = seconds / (24 * 60 * 60);
+        const uint daysUntilNextReview = static_cast<int>((daysSincePreviousReview - 1) * easinessFactor);
 
-        return p.reviewDate + daysUntilNextReview * 24 * 60 * 60;
+        return p.reviewDate + daysUntilNextReview * 24U * 60 * 60;
     }
 };
 
 Timestamp SuperMemo2ReviewStrategy::NextReview(const ReviewItem& item, const Timestamp& now) const noexcept
 {
+    DEJAVU_STATS_COUNT(StrategyNextReviewCalls, 1);
+
     return std::visit(NextReviewSuperMemo2Visitor{ now }, item);
 }
 
-DifficultyRating SuperMemo2ReviewStrategy::AdjustDifficulty(const ReviewItem& item, const ReviewOutcome& reviewOutcome)  const noexcept
+// -- same visitor, but switching on the tag directly so the whole loop stays in one function...
+void SuperMemo2ReviewStrategy::NextReviewBatch(const ReviewItem* items, size_t count, const Timestamp& now, Timestamp* out) const noexcept
 {
-    //EF':=EF+(0.1-(3-q)*(0.08+(3-q)*0.02))
-    //where:
-    //EF' - new value of the E-Factor,
-    //EF - old value of the E-Factor,
-    //q - quality of the response in the 0-3 grade scale.
-    //If EF is less than 1.3 then let EF be 1.3.
-    double outcome = ConvertOutcomeToNumber(reviewOutcome);
-    DifficultyRating rating = std::visit(
-        [](auto&& item) -> DifficultyRating { return item.difficultyRating; },
-        item);
-    const double currentEasinessFactor = DifficultyRatingToEasinessFactor(rating);
-    const double newEasinessFactor = currentEasinessFactor + (0.1 - (3 - outcome) * (0.08 + (3 - outcome) * 0.02));
-    double newDifficultyRating = EasinessFactorToDifficultyRating(newEasinessFactor);
+    DEJAVU_STATS_COUNT(StrategyBatchCards, count);
 
-    if (newDifficultyRating > 100)
-    {
-        newDifficultyRating = 100;
-    }
-    if (newDifficultyRating < 0)
+    NextReviewSuperMemo2Visitor visitor{ now };
+
+    for (size_t i = 0; i < count; i++)
     {
-        newDifficultyRating = 0;
-    }
+        const ReviewItem& item = items[i];
 
-    return static_cast<Timestamp>(newDifficultyRating);
+        switch (static_cast<CardState>(item.index()))
+        {
+        case CardState::NeverReviewed:
+        {
+            out[i] = visitor(*std::get_if<NeverReviewed>(&item));
+            break;
+        }
+        case CardState::PreviouslyIncorrect:
+        {
+            out[i] = visitor(*std::get_if<PreviouslyIncorrect>(&item));
+            break;
+        }
+        case CardState::PreviouslyFirstCorrect:
+        {
+            out[i] = visitor(*std::get_if<PreviouslyFirstCorrect>(&item));
+            break;
+        }
+        case CardState::PreviouslyCorrect:
+        default:
+        {
+            out[i] = visitor(*std::get_if<PreviouslyCorrect>(&item));
+            break;
+        }
+        }
+    }
 }
 
-double SuperMemo2ReviewStrategy::DifficultyRatingToEasinessFactor(uint difficultyRating) noexcept
+// -- only PreviouslyCorrect cards need real math, so gather those for the vector kernel and answer the rest directly...
+// -- SM-2 only ever adds intervals to a review date, so it schedules deck times as they are, without going through the epoch,
+// -- holding a due time past the end of deck time at DeckTimeMax the way CardStore::ToDeckTime does.
+void SuperMemo2ReviewStrategy::NextReviewColumns(const CardStore& cards, uint first, uint count, const DeckTime& now, DeckTime* out) const
 {
-    // using a linear equation - y = mx + b
-    return (-0.012 * difficultyRating) + 2.5;
-}
+    constexpr uint chunkSize = 256;
+    uint row[chunkSize];
+    uint8_t difficultyRating[chunkSize];
+    DeckTime reviewDate[chunkSize];
+    DeckTime previousCorrectReview[chunkSize];
+    DeckTime nextReview[chunkSize];
 
-// convert enum class to number for formula
-double SuperMemo2ReviewStrategy::ConvertOutcomeToNumber(const ReviewOutcome& reviewOutcome) noexcept
-{
-    double outcome = 0.0;
+    const CardState* states = cards.States().data() + first;
+    const uint8_t* difficultyRatings = cards.DifficultyRatings().data() + first;
+    const DeckTime* reviewDates = cards.ReviewDates().data() + first;
+    const DeckTime* previousCorrectReviews = cards.PreviousCorrectReviews().data() + first;
 
-    switch (reviewOutcome)
-    {
-    case ReviewOutcome::Perfect:
-    {
-        outcome = 3.0;
-        break;
-    }
-    case ReviewOutcome::Hesitant:
-    {
-        outcome = 2.0;
-        break;
-    }
-    case ReviewOutcome::Incorrect:
-    {
-        outcome = 1.0;
-        break;
-    }
-    case ReviewOutcome::NeverReviewed:
+    DEJAVU_STATS_COUNT(StrategyBatchCards, count);
+
+    NextReviewSuperMemo2Visitor visitor{ now };
+
+    for (uint start = 0; start < count; start += chunkSize)
     {
-        outcome = 0.0;
-        break;
-    }
-    }
+        const uint end = (count - start < chunkSize) ? count : start + chunkSize;
+        uint gathered = 0;
+
+        for (uint i = start; i < end; i++)
+        {
+            switch (states[i])
+            {
+            case CardState::NeverReviewed:
+            case CardState::PreviouslyIncorrect:
+            {
+                out[i] = now;
+                break;
+            }
+            case CardState::PreviouslyFirstCorrect:
+            {
+                out[i] = static_cast<DeckTime>(std::min<Timestamp>(visitor(PreviouslyFirstCorrect{ difficultyRatings[i], reviewDates[i] }), DeckTimeMax));
+                break;
+            }
+            case CardState::PreviouslyCorrect:
+            default:
+            {
+                row[gathered] = i;
+                difficultyRating[gathered] = difficultyRatings[i];
+                reviewDate[gathered] = reviewDates[i];
+                previousCorrectReview[gathered] = previousCorrectReviews[i];
+                gathered++;
+                break;
+            }
+            }
+        }
 
-    return outcome;
+        NextReviewPreviouslyCorrect(difficultyRating, reviewDate, previousCorrectReview, gathered, nextReview);
+
+        for (uint j = 0; j < gathered; j++)
+        {
+            out[row[j]] = nextReview[j];
+        }
+    }
 }
 
-double SuperMemo2ReviewStrategy::EasinessFactorToDifficultyRating(double easinessFactor) noexcept
+// -- table lookup instead of float math, ratings are clamped so out of range input can't read past the table...
+DifficultyRating SuperMemo2ReviewStrategy::AdjustDifficulty(const ReviewItem& item, const ReviewOutcome& reviewOutcome)  const noexcept
 {
-    // using a linear equation - x = (y - b)/m
-    return (easinessFactor - 2.5) / -0.012;
+    DEJAVU_STATS_COUNT(StrategyAdjustDifficultyCalls, 1);
+
+    const DifficultyRating rating = std::visit(
+        [](auto&& item) -> DifficultyRating { return item.difficultyRating; },
+        item);
+    const DifficultyRating clampedRating = std::min(rating, DifficultyRatingMostDifficult);
+
+    return AdjustDifficultyTable[clampedRating * ReviewOutcomeCount + static_cast<uint>(reviewOutcome)];
 }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace jlimdev
+{
+    // -- the SM-2 formulas only ever see 101 ratings and 4 outcomes, so answer them from tables built at compile time...
+
+    constexpr uint DifficultyRatingCount = DifficultyRatingMostDifficult + 1;
+    constexpr uint ReviewOutcomeCount = 4;
+
+    constexpr std::array<double, DifficultyRatingCount> BuildEasinessFactorTable() noexcept
+    {
+        std::array<double, DifficultyRatingCount> table{};
+
+        for (uint rating = 0; rating < DifficultyRatingCount; rating++)
+        {
+            table[rating] = SuperMemo2ReviewStrategy::DifficultyRatingToEasinessFactor(rating);
+        }
+
+        return table;
+    }
+
+    // -- indexed by rating * ReviewOutcomeCount + outcome...
+    constexpr std::array<uint8_t, DifficultyRatingCount * ReviewOutcomeCount> BuildAdjustDifficultyTable() noexcept
+    {
+        std::array<uint8_t, DifficultyRatingCount * ReviewOutcomeCount> table{};
+
+        for (uint rating = 0; rating < DifficultyRatingCount; rating++)
+        {
+            for (uint outcome = 0; outcome < ReviewOutcomeCount; outcome++)
+            {
+                table[rating * ReviewOutcomeCount + outcome] = static_cast<uint8_t>(
+                    SuperMemo2ReviewStrategy::AdjustDifficultyRating(rating, static_cast<ReviewOutcome>(outcome)));
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr std::array<double, DifficultyRatingCount> EasinessFactorTable = BuildEasinessFactorTable();
+    inline constexpr std::array<uint8_t, DifficultyRatingCount * ReviewOutcomeCount> AdjustDifficultyTable = BuildAdjustDifficultyTable();
+
+    static_assert(static_cast<uint>(ReviewOutcome::NeverReviewed) + 1 == ReviewOutcomeCount);
+}
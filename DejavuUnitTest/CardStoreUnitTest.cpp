@@ -0,0 +1,82 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(CardStoreUnitTest)
+    {
+        CardStore store;
+
+    public:
+        TEST_METHOD(every_review_item_should_round_trip_through_the_columns)
+        {
+            store.Add(NeverReviewed{ DifficultyRatingMostDifficult });
+            store.Add(PreviouslyIncorrect{ 61, 1000 });
+            store.Add(PreviouslyFirstCorrect{ 50, 2000 });
+            store.Add(PreviouslyCorrect{ 41, 3000, 1500 });
+
+            Assert::AreEqual(store.Size(), 4U);
+
+            Assert::AreEqual(std::get<NeverReviewed>(store.At(0)).difficultyRating, DifficultyRatingMostDifficult);
+
+            const PreviouslyIncorrect incorrect = std::get<PreviouslyIncorrect>(store.At(1));
+            Assert::AreEqual(incorrect.difficultyRating, 61U);
+            Assert::AreEqual(incorrect.reviewDate, static_cast<Timestamp>(1000));
+
+            const PreviouslyFirstCorrect firstCorrect = std::get<PreviouslyFirstCorrect>(store.At(2));
+            Assert::AreEqual(firstCorrect.difficultyRating, 50U);
+            Assert::AreEqual(firstCorrect.reviewDate, static_cast<Timestamp>(2000));
+
+            const PreviouslyCorrect correct = std::get<PreviouslyCorrect>(store.At(3));
+            Assert::AreEqual(correct.difficultyRating, 41U);
+            Assert::AreEqual(correct.reviewDate, static_cast<Timestamp>(3000));
+            Assert::AreEqual(correct.previousCorrectReview, static_cast<Timestamp>(1500));
+        }
+
+        TEST_METHOD(setting_a_card_should_clear_fields_the_new_state_does_not_have)
+        {
+            store.Add(PreviouslyCorrect{ 41, 3000, 1500 });
+
+            store.Set(0, PreviouslyIncorrect{ 61, 4000 });
+
+            Assert::IsTrue(store.State(0) == CardState::PreviouslyIncorrect);
+            Assert::AreEqual(store.Difficulty(0), 61U);
+            Assert::AreEqual(store.ReviewDates()[0], 4000U);
+            Assert::AreEqual(store.PreviousCorrectReviews()[0], 0U);
+        }
+
+        TEST_METHOD(rebased_store_should_keep_its_dates_and_take_ones_past_2106)
+        {
+            const Timestamp late = 4200000000U;
+            const Timestamp past2106 = 4400000000U;
+
+            store.Add(PreviouslyCorrect{ 41, late, late - 1000000 });
+            Assert::IsFalse(store.Fits(past2106));
+
+            Assert::IsTrue(store.Rebase(past2106, past2106));
+            Assert::IsTrue(store.Epoch() > 0);
+            Assert::IsTrue(store.Fits(past2106));
+
+            store.Add(PreviouslyIncorrect{ 61, past2106 });
+
+            const PreviouslyCorrect correct = std::get<PreviouslyCorrect>(store.At(0));
+            Assert::AreEqual(correct.reviewDate, late);
+            Assert::AreEqual(correct.previousCorrectReview, late - 1000000);
+            Assert::AreEqual(std::get<PreviouslyIncorrect>(store.At(1)).reviewDate, past2106);
+            Assert::AreEqual(store.ToDeckTime(DueImmediately), 0U);
+        }
+
+        TEST_METHOD(rebase_should_refuse_dates_further_apart_than_deck_time_holds)
+        {
+            store.Add(PreviouslyIncorrect{ 61, 1000 });
+
+            Assert::IsFalse(store.Rebase(5000000000U, 5000000000U));
+            Assert::AreEqual(store.Epoch(), static_cast<Timestamp>(0));
+            Assert::AreEqual(std::get<PreviouslyIncorrect>(store.At(0)).reviewDate, static_cast<Timestamp>(1000));
+        }
+    };
+}
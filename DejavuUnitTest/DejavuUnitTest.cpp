@@ -13,7 +13,7 @@ namespace FlashcardUnitTest
         const ReviewOutcome hesitant = ReviewOutcome::Hesitant;
         const ReviewOutcome perfect = ReviewOutcome::Perfect;
 
-        uint now;
+        Timestamp now;
         SuperMemo2ReviewStrategy strategy;
         std::unique_ptr<StudySession> session;
 
@@ -24,7 +24,7 @@ namespace FlashcardUnitTest
         TEST_METHOD_INITIALIZE(setup_session_and_strategy)
         {
             // method initialization code
-            now = static_cast<int>(time(nullptr));
+            now = static_cast<Timestamp>(time(nullptr));
             session = std::make_unique<StudySession>(strategy, maxNewCardsInSession, maxExistingCardsInSession, maxCards);
         }
 
@@ -142,10 +142,12 @@ namespace FlashcardUnitTest
 
             session->UpdateCard(0, ReviewOutcome::Incorrect, now);
 
-            Assert::IsTrue(std::get_if<PreviouslyIncorrect>(&session->At(0)));
+            const ReviewItem item = session->At(0);
+
+            Assert::IsTrue(std::get_if<PreviouslyIncorrect>(&item));
         }
 
-        uint ReviewDateHelperCorrect(ReviewOutcome outcome, uint now)
+        Timestamp ReviewDateHelperCorrect(ReviewOutcome outcome, Timestamp now)
         {
             ReviewItemBuilder().Due(*session, 1);
 
@@ -154,7 +156,7 @@ namespace FlashcardUnitTest
             return std::get<PreviouslyCorrect>(session->At(0)).reviewDate;
         }
 
-        uint ReviewDateHelperIncorrect(uint now)
+        Timestamp ReviewDateHelperIncorrect(Timestamp now)
         {
             ReviewItemBuilder().Due(*session, 1);
 
@@ -302,6 +304,160 @@ namespace FlashcardUnitTest
             Assert::AreEqual(session->NextReview(now).has_value(), false);
         }
 
+        TEST_METHOD(future_item_should_be_reviewed_once_it_becomes_due)
+        {
+            ReviewItemListBuilder().WithFutureItems(*session, 1);
+
+            Assert::AreEqual(session->NextReview(now).has_value(), false);
+
+            uint index = session->NextReview(now + Days(30)).value();
+            Assert::AreEqual(index, 0U);
+            session->UpdateCard(index, hesitant, now + Days(30));
+
+            Assert::AreEqual(session->NextReview(now + Days(30)).has_value(), false);
+        }
+
+        TEST_METHOD(swapping_strategy_should_reschedule_cards)
+        {
+            ReviewItemListBuilder().WithFutureItems(*session, 2);
+
+            Assert::AreEqual(session->NextReview(now).has_value(), false);
+
+            SimpleReviewStrategy simpleStrategy;
+            session->SetReviewStrategy(simpleStrategy);
+
+            Assert::AreEqual(session->GetNextReviewTime(1, now), now);
+            Assert::AreEqual(session->NextReview(now).value(), 0U);
+
+            session->SetReviewStrategy(strategy);
+
+            Assert::AreEqual(session->NextReview(now).has_value(), false);
+        }
+
+        TEST_METHOD(imported_deck_should_study_the_same_as_cards_added_one_at_a_time)
+        {
+            const DeckRecord records[] = {
+                { CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 },
+                { CardState::PreviouslyCorrect, DifficultyRatingMostDifficult, 0, now - Days(10) - 1, now - Days(12) },
+                { CardState::PreviouslyCorrect, DifficultyRatingEasiest, 0, now - Days(2), now - Days(12) },
+                { CardState::PreviouslyIncorrect, 61, 0, now - Days(1), 0 },
+                { CardState::PreviouslyFirstCorrect, 50, 0, now - Days(7), 0 }
+            };
+
+            session->AddNeverReviewed();
+            session->AddPreviouslyCorrect(DifficultyRatingMostDifficult, now - Days(10) - 1, now - Days(12));
+            session->AddPreviouslyCorrect(DifficultyRatingEasiest, now - Days(2), now - Days(12));
+            session->AddPreviouslyIncorrect(61, now - Days(1));
+            session->AddPreviouslyFirstCorrect(50, now - Days(7));
+
+            StudySession imported(strategy, maxNewCardsInSession, maxExistingCardsInSession, maxCards);
+            Assert::AreEqual(imported.ImportRecords(records, 5), 5U);
+
+            for (uint i = 0; i < 5; i++)
+            {
+                Assert::AreEqual(imported.At(i).index(), session->At(i).index());
+                Assert::AreEqual(imported.GetNextReviewTime(i, now), session->GetNextReviewTime(i, now));
+            }
+
+            for (std::optional<uint> index = session->NextReview(now); index; index = session->NextReview(now))
+            {
+                Assert::AreEqual(imported.NextReview(now).value(), *index);
+                session->UpdateCard(*index, hesitant, now);
+                imported.UpdateCard(*index, hesitant, now);
+            }
+
+            Assert::AreEqual(imported.NextReview(now).has_value(), false);
+        }
+
+        TEST_METHOD(import_should_stop_at_first_invalid_record)
+        {
+            const DeckRecord records[] = {
+                { CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 },
+                { CardState::PreviouslyIncorrect, DifficultyRatingMostDifficult + 1, 0, now, 0 },
+                { CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 }
+            };
+
+            Assert::AreEqual(session->ImportRecords(records, 3), 1U);
+            Assert::AreEqual(session->NextReview(now).value(), 0U);
+            session->UpdateCard(0, hesitant, now);
+            Assert::AreEqual(session->NextReview(now).has_value(), false);
+        }
+
+        TEST_METHOD(deck_should_fill_up_to_its_card_limit_and_no_further)
+        {
+            const DeckRecord records[] = {
+                { CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 },
+                { CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 },
+                { CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 }
+            };
+
+            StudySession limited(strategy, maxNewCardsInSession, maxExistingCardsInSession, 4);
+            Assert::IsTrue(limited.AddNeverReviewed());
+
+            // -- as many as there is room for...
+            Assert::AreEqual(limited.ImportRecords(records, 3), 3U);
+            Assert::AreEqual(limited.Size(), 4U);
+
+            Assert::IsFalse(limited.AddNeverReviewed());
+            Assert::AreEqual(limited.ImportRecords(records, 3), 0U);
+            Assert::AreEqual(limited.Size(), 4U);
+
+            StudySession cutOff(strategy, maxNewCardsInSession, maxExistingCardsInSession, 2);
+            Assert::AreEqual(cutOff.ImportRecords(records, 3), 2U);
+            Assert::AreEqual(cutOff.Size(), 2U);
+        }
+
+        TEST_METHOD(exported_deck_should_carry_cards_and_next_review_times)
+        {
+            ReviewItemListBuilder()
+                .WithNewItems(*session, 2)
+                .WithDueItems(*session, 2)
+                .WithFutureItems(*session, 2);
+
+            session->UpdateCard(0, incorrect, now);
+            session->UpdateCard(2, perfect, now);
+
+            std::vector<ExportedRecord> exported(session->Size());
+            session->ExportRecords(now, exported.data());
+
+            StudySession imported(strategy, maxNewCardsInSession, maxExistingCardsInSession, maxCards);
+
+            for (uint i = 0; i < exported.size(); i++)
+            {
+                Assert::AreEqual(exported[i].index, i);
+                Assert::AreEqual(exported[i].nextReview, session->GetNextReviewTime(i, now));
+                Assert::AreEqual(imported.ImportRecords(&exported[i].card, 1), 1U);
+                Assert::AreEqual(imported.At(i).index(), session->At(i).index());
+                Assert::AreEqual(imported.GetNextReviewTime(i, now), session->GetNextReviewTime(i, now));
+            }
+        }
+
+        TEST_METHOD(only_answered_cards_should_be_exported_until_commit)
+        {
+            ReviewItemListBuilder().WithNewItems(*session, 4);
+
+            Assert::AreEqual(session->DirtyCards().size(), size_t(0));
+
+            session->UpdateCard(2, incorrect, now);
+            session->UpdateCard(0, perfect, now);
+            session->UpdateCard(2, perfect, now);
+
+            std::vector<ExportedRecord> dirty(session->DirtyCards().size());
+            session->ExportDirtyRecords(now, dirty.data());
+
+            Assert::AreEqual(dirty.size(), size_t(2));
+            Assert::AreEqual(dirty[0].index, 2U);
+            Assert::AreEqual(dirty[1].index, 0U);
+            Assert::IsTrue(dirty[0].card.state == CardState::PreviouslyFirstCorrect);
+            Assert::AreEqual(dirty[0].nextReview, session->GetNextReviewTime(2, now));
+
+            session->CommitDirtyCards();
+            Assert::AreEqual(session->DirtyCards().size(), size_t(0));
+
+            session->UpdateCard(2, hesitant, now);
+            Assert::AreEqual(session->DirtyCards().size(), size_t(1));
+        }
+
         TEST_METHOD(difficult_card_should_be_due_in_short_period)
         {
             Timestamp reviewDate = now - Days(1);
@@ -322,7 +478,7 @@ namespace FlashcardUnitTest
             auto interval = (givenDate - now)/ (Days(1));
 
             Assert::AreEqual(givenDate, expectedDate);
-            Assert::AreEqual(interval, 13U);
+            Assert::AreEqual(interval, static_cast<Timestamp>(13));
             
             // test with an outcome now...
             // review date is now, previous review 11 days ago, before that is not used
@@ -330,11 +486,11 @@ namespace FlashcardUnitTest
 
             session->AddPreviouslyCorrect(DifficultyRatingMostDifficult, previousCorrectReview, reviewPriorToLastReview);
 
-            uint afterOutcome = session->UpdateCard(1, ReviewOutcome::Perfect, now);
+            Timestamp afterOutcome = session->UpdateCard(1, ReviewOutcome::Perfect, now).value();
 
             auto outcomeInterval = (afterOutcome - now) / Days(1);
 
-            Assert::AreEqual(outcomeInterval, 15U);
+            Assert::AreEqual(outcomeInterval, static_cast<Timestamp>(15));
 
             // a positive outcome should make the interval longer...
             Assert::IsTrue(outcomeInterval > interval);
@@ -4,6 +4,10 @@
 
 namespace jlimdev
 {
+    // -- the clock for tests that work out due times, fixed so they come out the same on every run...
+    constexpr Timestamp now = 1600000000U;
+    constexpr Timestamp day = 24 * 60 * 60;
+
     class ReviewItemBuilder
     {
         uint correctReviewStreak = 0;
@@ -129,4 +133,132 @@ namespace jlimdev
             return *this;
         }
     };
+
+    /// <summary>
+    /// A deck of DeckRecords for ImportRecords, dated against now. Mixed cards deal new, due, not yet due and wrong
+    /// cards out in turn, so any stretch of the deck, e.g. one streamed chunk, holds a bit of each.
+    /// </summary>
+    class DeckRecordBuilder
+    {
+        std::vector<DeckRecord> records;
+
+    public:
+        DeckRecordBuilder& WithNewCards(uint count)
+        {
+            for (uint i = 0; i < count; i++)
+            {
+                records.push_back(DeckRecord{ CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 });
+            }
+
+            return *this;
+        }
+
+        // -- due over a week ago, each a second apart from the one before so none come due at quite the same time...
+        DeckRecordBuilder& WithDueCards(uint count)
+        {
+            for (uint i = 0; i < count; i++)
+            {
+                const Timestamp reviewDate = now - 10 * day - records.size();
+                records.push_back(DeckRecord{ CardState::PreviouslyCorrect, 50, 0, reviewDate, now - 12 * day });
+            }
+
+            return *this;
+        }
+
+        DeckRecordBuilder& WithFutureCards(uint count)
+        {
+            for (uint i = 0; i < count; i++)
+            {
+                records.push_back(DeckRecord{ CardState::PreviouslyCorrect, DifficultyRatingEasiest, 0, now - day, now - 12 * day });
+            }
+
+            return *this;
+        }
+
+        DeckRecordBuilder& WithIncorrectCards(uint count)
+        {
+            for (uint i = 0; i < count; i++)
+            {
+                records.push_back(DeckRecord{ CardState::PreviouslyIncorrect, 50, 0, now - 2 * day, 0 });
+            }
+
+            return *this;
+        }
+
+        DeckRecordBuilder& WithMixedCards(uint count)
+        {
+            for (uint i = 0; i < count; i++)
+            {
+                switch (records.size() % 4)
+                {
+                case 0:
+                    WithNewCards(1);
+                    break;
+                case 1:
+                    WithDueCards(1);
+                    break;
+                case 2:
+                    WithFutureCards(1);
+                    break;
+                default:
+                    WithIncorrectCards(1);
+                    break;
+                }
+            }
+
+            return *this;
+        }
+
+        std::vector<DeckRecord> Build() const
+        {
+            return records;
+        }
+
+        template <typename Session>
+        uint ImportInto(Session& session) const
+        {
+            return session.ImportRecords(records.data(), static_cast<uint>(records.size()));
+        }
+    };
+
+    // -- both sessions hold the same cards, and hand out and schedule the same ones from here on...
+    inline void AssertStudiesTheSame(StudySession& expected, StudySession& actual, Timestamp now)
+    {
+        using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+        Assert::AreEqual(actual.Size(), expected.Size());
+
+        std::vector<ExportedRecord> expectedRecords(expected.Size());
+        std::vector<ExportedRecord> actualRecords(actual.Size());
+        expected.ExportRecords(now, expectedRecords.data());
+        actual.ExportRecords(now, actualRecords.data());
+
+        for (uint i = 0; i < expected.Size(); i++)
+        {
+            Assert::IsTrue(actualRecords[i].card.state == expectedRecords[i].card.state);
+            Assert::AreEqual(actualRecords[i].card.difficultyRating, expectedRecords[i].card.difficultyRating);
+            Assert::AreEqual(actualRecords[i].card.reviewDate, expectedRecords[i].card.reviewDate);
+            Assert::AreEqual(actualRecords[i].card.previousCorrectReview, expectedRecords[i].card.previousCorrectReview);
+            Assert::AreEqual(actualRecords[i].nextReview, expectedRecords[i].nextReview);
+        }
+
+        for (const Timestamp time : { now, now + 2 * 24 * 60 * 60, now + 200 * 24 * 60 * 60 })
+        {
+            for (;;)
+            {
+                const std::optional<uint> expectedIndex = expected.NextReview(time);
+                const std::optional<uint> actualIndex = actual.NextReview(time);
+
+                Assert::IsTrue(actualIndex == expectedIndex);
+
+                if (!expectedIndex)
+                {
+                    break;
+                }
+
+                expected.UpdateCard(*expectedIndex, ReviewOutcome::Hesitant, time);
+                actual.UpdateCard(*actualIndex, ReviewOutcome::Hesitant, time);
+            }
+        }
+    }
 }
\ No newline at end of file
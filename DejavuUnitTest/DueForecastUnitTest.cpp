@@ -0,0 +1,74 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(DueForecastUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+    public:
+        TEST_METHOD(forecast_should_count_each_card_on_the_day_it_comes_due)
+        {
+            StudySession session(strategy, 5, 5, 100);
+
+            session.AddNeverReviewed();
+            session.AddPreviouslyIncorrect(50, now - day);
+            session.AddPreviouslyFirstCorrect(50, now - 10 * day);
+            session.AddPreviouslyCorrect(DifficultyRatingEasiest, now - 2 * day, now - 12 * day);
+            session.AddPreviouslyCorrect(DifficultyRatingEasiest, now + 100 * day, now + 90 * day);
+
+            const uint days = 30;
+            std::vector<uint> expected(days, 0U);
+
+            for (uint i = 0; i < session.Size(); i++)
+            {
+                const Timestamp due = session.GetNextReviewTime(i, now);
+                const Timestamp dueDay = (due <= now) ? 0 : (due - now) / day;
+
+                if (dueDay < days)
+                {
+                    expected[dueDay]++;
+                }
+            }
+
+            std::vector<uint> counts(days);
+            session.ForecastDueCounts(now, days, counts.data());
+
+            for (uint d = 0; d < days; d++)
+            {
+                Assert::AreEqual(counts[d], expected[d]);
+            }
+
+            Assert::AreEqual(counts[0], 3U);
+        }
+
+        TEST_METHOD(parallel_forecast_should_match_counting_on_one_thread)
+        {
+            std::mt19937 random(15);
+            std::vector<DeckTime> dueAt(5 * ForecastCardsPerThread + 123);
+
+            for (DeckTime& due : dueAt)
+            {
+                due = static_cast<DeckTime>((random() % 8 == 0) ? DueImmediately : now - 5 * day + random() % (60 * day));
+            }
+
+            const uint days = 30;
+            std::vector<uint> single(days);
+            std::vector<uint> parallel(days);
+
+            ForecastDueCounts(dueAt.data(), dueAt.size(), static_cast<DeckTime>(now), days, single.data(), 1);
+            ForecastDueCounts(dueAt.data(), dueAt.size(), static_cast<DeckTime>(now), days, parallel.data(), 4);
+
+            for (uint d = 0; d < days; d++)
+            {
+                Assert::AreEqual(parallel[d], single[d]);
+            }
+        }
+    };
+}
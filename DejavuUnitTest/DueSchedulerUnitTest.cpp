@@ -0,0 +1,173 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+#include <map>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(DueSchedulerUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+    public:
+        TEST_METHOD(wheel_should_hand_out_every_card_once_no_earlier_than_its_due_time)
+        {
+            const Timestamp tick = 60;
+            DueTimingWheel wheel(now, tick);
+            std::mt19937 random(21);
+            std::vector<Timestamp> dueAt(5000);
+
+            // -- minutes to years out, so every level and the overflow get some...
+            for (uint i = 0; i < dueAt.size(); i++)
+            {
+                const Timestamp range = (i % 5 == 4) ? 1000 * day : (i % 5 == 3) ? 100 * day : (i % 5 == 2) ? 3 * day : 2 * 60 * 60;
+                dueAt[i] = now - 60 + random() % range;
+                wheel.Schedule(DueCard{ SessionKey{ 1, 1 }, i, dueAt[i] });
+            }
+
+            std::vector<uint> handedOut(dueAt.size(), 0U);
+            Timestamp clock = now;
+
+            // -- uneven steps, some inside one tick and some across many...
+            while (wheel.Size() != 0)
+            {
+                clock += (random() % 4 == 0) ? static_cast<Timestamp>(random() % (20 * day)) : static_cast<Timestamp>(random() % (2 * tick));
+
+                wheel.Advance(clock, [&](const DueCard& card)
+                {
+                    Assert::IsTrue(card.dueAt <= clock);
+                    handedOut[card.card]++;
+                });
+            }
+
+            for (uint count : handedOut)
+            {
+                Assert::AreEqual(count, 1U);
+            }
+        }
+
+        TEST_METHOD(wheel_should_not_be_late_by_more_than_a_tick_when_advanced_every_tick)
+        {
+            const Timestamp tick = 30;
+            DueTimingWheel wheel(now, tick);
+
+            for (uint i = 0; i < 300; i++)
+            {
+                wheel.Schedule(DueCard{ SessionKey{ 1, 1 }, i, now + i * 997 });
+            }
+
+            // -- on tick boundaries, the way a server's timer would fire...
+            for (Timestamp clock = now - now % tick; wheel.Size() != 0; clock += tick)
+            {
+                wheel.Advance(clock, [&](const DueCard& card)
+                {
+                    Assert::IsTrue(card.dueAt <= clock);
+                    Assert::IsTrue(clock - card.dueAt < tick);
+                });
+            }
+        }
+
+        TEST_METHOD(scheduler_should_tell_when_a_deck_comes_due_and_forget_answered_cards)
+        {
+            SuperMemo2StudySession session(strategy, 5, 5, 100);
+            session.AddPreviouslyCorrect(DifficultyRatingEasiest, now - 2 * day, now - 12 * day);
+            session.AddPreviouslyFirstCorrect(50, now - 5 * day);
+            session.AddPreviouslyFirstCorrect(50, now - 4 * day);
+
+            const SessionKey key{ 3, 1 };
+            DueScheduler scheduler(now);
+            scheduler.Track(key, session);
+
+            std::vector<std::pair<uint, uint>> due;
+            const auto record = [&due](const SessionKey&, uint card, uint dueCount) { due.emplace_back(card, dueCount); };
+
+            scheduler.Advance(now, record);
+            Assert::AreEqual(due.size(), static_cast<size_t>(0));
+            Assert::AreEqual(session.NextReview(now).has_value(), false);
+
+            // -- six days after each first correct answer, one a day apart...
+            scheduler.Advance(now + day + 60, record);
+            Assert::AreEqual(due.size(), static_cast<size_t>(1));
+            Assert::AreEqual(due[0].first, 1U);
+            Assert::AreEqual(due[0].second, 1U);
+            Assert::AreEqual(scheduler.DueCount(key), 1U);
+
+            Assert::IsTrue(session.PromoteCard(1, now + day + 60));
+            Assert::IsFalse(session.PromoteCard(2, now + day + 60));
+
+            // -- answered, so it no longer counts, and the old entry doesn't come back...
+            const Timestamp next = session.UpdateCard(1, ReviewOutcome::Perfect, now + day + 60).value();
+            scheduler.Reschedule(key, 1, next);
+            Assert::AreEqual(scheduler.DueCount(key), 0U);
+
+            scheduler.Advance(now + 2 * day + 60, record);
+            Assert::AreEqual(due.size(), static_cast<size_t>(2));
+            Assert::AreEqual(due[1].first, 2U);
+            Assert::AreEqual(due[1].second, 1U);
+
+            scheduler.Untrack(key);
+            Assert::AreEqual(scheduler.DueCount(key), 0U);
+            scheduler.Advance(now + 1000 * day, record);
+            Assert::AreEqual(due.size(), static_cast<size_t>(2));
+        }
+
+        TEST_METHOD(scheduler_should_sweep_out_entries_left_behind_by_retracking_and_rescheduling)
+        {
+            const uint cards = 100;
+            SuperMemo2StudySession session(strategy, cards, cards, cards);
+
+            for (uint i = 0; i < cards; i++)
+            {
+                session.AddPreviouslyFirstCorrect(50, now - i * 60);
+            }
+
+            const SessionKey key{ 4, 1 };
+            DueScheduler scheduler(now);
+
+            // -- without sweeping, every retrack and every answer would leave one more entry per card...
+            for (uint round = 0; round < 10; round++)
+            {
+                scheduler.Track(key, session);
+                Assert::AreEqual(scheduler.Scheduled(), static_cast<size_t>(cards));
+                Assert::IsTrue(scheduler.Stale() <= cards);
+            }
+
+            for (uint round = 1; round <= 10; round++)
+            {
+                for (uint i = 0; i < cards; i++)
+                {
+                    scheduler.Reschedule(key, i, now + round * day + i * 60);
+                }
+
+                Assert::AreEqual(scheduler.Scheduled(), static_cast<size_t>(cards));
+                Assert::IsTrue(scheduler.Stale() <= cards);
+            }
+
+            // -- the same time again keeps the entry already there...
+            const size_t stale = scheduler.Stale();
+            scheduler.Reschedule(key, 0, now + 10 * day);
+            Assert::AreEqual(scheduler.Stale(), stale);
+
+            std::vector<uint> handedOut(cards, 0U);
+            scheduler.Advance(now + 11 * day, [&](const SessionKey&, uint card, uint) { handedOut[card]++; });
+
+            for (uint count : handedOut)
+            {
+                Assert::AreEqual(count, 1U);
+            }
+
+            Assert::AreEqual(scheduler.Scheduled(), static_cast<size_t>(0));
+            Assert::AreEqual(scheduler.Stale(), static_cast<size_t>(0));
+
+            // -- and an untracked deck leaves nothing behind at all...
+            scheduler.Track(key, session);
+            scheduler.Untrack(key);
+            Assert::AreEqual(scheduler.Scheduled(), static_cast<size_t>(0));
+            Assert::AreEqual(scheduler.Stale(), static_cast<size_t>(0));
+        }
+    };
+}
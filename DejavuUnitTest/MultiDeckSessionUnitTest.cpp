@@ -0,0 +1,103 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(MultiDeckSessionUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+    public:
+        TEST_METHOD(picks_should_take_turns_across_decks)
+        {
+            SuperMemo2MultiDeckSession session(strategy, 100, 100, 100);
+            DeckRecordBuilder().WithNewCards(3).ImportInto(*session.AddDeck(7));
+            DeckRecordBuilder().WithNewCards(1).ImportInto(*session.AddDeck(9));
+
+            const uint expectedDecks[] = { 7, 9, 7, 7 };
+            const uint expectedCards[] = { 0, 0, 1, 2 };
+
+            for (uint n = 0; n < 4; n++)
+            {
+                const DeckCard next = session.NextReview(now).value();
+
+                Assert::AreEqual(next.deck, expectedDecks[n]);
+                Assert::AreEqual(next.card, expectedCards[n]);
+                session.UpdateCard(next, ReviewOutcome::Perfect, now);
+            }
+
+            Assert::IsFalse(session.NextReview(now).has_value());
+        }
+
+        TEST_METHOD(caps_should_be_shared_by_every_deck)
+        {
+            SuperMemo2MultiDeckSession session(strategy, 3, 2, 100);
+            SuperMemo2StudySession* first = session.AddDeck(1);
+            SuperMemo2StudySession* second = session.AddDeck(2);
+            DeckRecordBuilder().WithNewCards(5).WithDueCards(5).ImportInto(*first);
+            DeckRecordBuilder().WithNewCards(5).WithDueCards(5).ImportInto(*second);
+
+            uint handedOut = 0;
+
+            while (std::optional<DeckCard> next = session.NextReview(now))
+            {
+                session.UpdateCard(*next, ReviewOutcome::Perfect, now);
+                handedOut++;
+            }
+
+            Assert::AreEqual(handedOut, 5U);
+            Assert::AreEqual(session.NewCardsReturned(), 3U);
+            Assert::AreEqual(session.ExistingCardsReturned(), 2U);
+        }
+
+        TEST_METHOD(deck_caps_should_split_the_shared_ones)
+        {
+            SuperMemo2MultiDeckSession session(strategy, 10, 10, 100);
+            DeckRecordBuilder().WithNewCards(5).ImportInto(*session.AddDeck(1, 1, 0));
+            DeckRecordBuilder().WithNewCards(5).ImportInto(*session.AddDeck(2));
+
+            uint fromFirst = 0;
+
+            while (std::optional<DeckCard> next = session.NextReview(now))
+            {
+                fromFirst += (next->deck == 1) ? 1 : 0;
+                session.UpdateCard(*next, ReviewOutcome::Perfect, now);
+            }
+
+            Assert::AreEqual(fromFirst, 1U);
+            Assert::AreEqual(session.NewCardsReturned(), 6U);
+        }
+
+        TEST_METHOD(decks_should_come_and_go_without_touching_the_others)
+        {
+            SuperMemo2MultiDeckSession session(strategy, 100, 100, 100);
+            DeckRecordBuilder().WithNewCards(2).ImportInto(*session.AddDeck(1));
+            DeckRecordBuilder().WithNewCards(2).ImportInto(*session.AddDeck(2));
+
+            const DeckCard first = session.NextReview(now).value();
+            session.UpdateCard(first, ReviewOutcome::Incorrect, now);
+            Assert::AreEqual(first.deck, 1U);
+
+            Assert::IsTrue(session.AddDeck(1) == nullptr);
+            Assert::IsTrue(session.RemoveDeck(2));
+            Assert::IsFalse(session.RemoveDeck(2));
+            DeckRecordBuilder().WithNewCards(1).ImportInto(*session.AddDeck(3));
+
+            // -- deck 1 kept its wrong card and where it was up to...
+            Assert::IsTrue(session.FindDeck(1)->At(0).index() == static_cast<size_t>(CardState::PreviouslyIncorrect));
+            Assert::AreEqual(session.DeckCount(), static_cast<size_t>(2));
+            Assert::AreEqual(session.Size(), 3U);
+
+            const DeckCard next = session.NextReview(now).value();
+            Assert::AreEqual(next.deck, 1U);
+            Assert::AreEqual(next.card, 1U);
+            Assert::AreEqual(session.NextReview(now).value().deck, 3U);
+
+            Assert::IsFalse(session.UpdateCard(DeckCard{ 2, 0 }, ReviewOutcome::Perfect, now).has_value());
+        }
+    };
+}
@@ -0,0 +1,199 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+#include <cstdio>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(ReviewLogUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+        void LoadDeck(StudySession& session)
+        {
+            session.AddNeverReviewed();
+            session.AddPreviouslyIncorrect(50, now - day);
+            session.AddPreviouslyFirstCorrect(50, now - 10 * day);
+            session.AddPreviouslyCorrect(50, now + 100 * day, now + 90 * day);
+            session.AddNeverReviewed();
+        }
+
+        void Answer(StudySession& session, const std::vector<ReviewOutcome>& outcomes)
+        {
+            for (const ReviewOutcome outcome : outcomes)
+            {
+                session.UpdateCard(session.NextReview(now).value(), outcome, now);
+            }
+        }
+
+    public:
+        TEST_METHOD(snapshot_plus_log_should_replay_to_the_live_session)
+        {
+            ReviewLog log;
+            StudySession live(strategy, 5, 5, 100);
+            LoadDeck(live);
+
+            std::vector<uint8_t> snapshot;
+            live.SaveSnapshot(snapshot);
+
+            live.SetReviewLog(&log);
+            Answer(live, { ReviewOutcome::Incorrect, ReviewOutcome::Perfect, ReviewOutcome::Hesitant, ReviewOutcome::Incorrect });
+
+            Assert::AreEqual(log.Size(), static_cast<size_t>(4));
+            Assert::AreEqual(log.Events()[0].outcome, static_cast<uint8_t>(ReviewOutcome::Incorrect));
+
+            StudySession restored(strategy, 5, 5, 100);
+            Assert::IsTrue(restored.Restore(snapshot.data(), snapshot.size(), log));
+            Assert::AreEqual(restored.ReviewSequence(), live.ReviewSequence());
+
+            AssertStudiesTheSame(live, restored, now);
+        }
+
+        TEST_METHOD(log_file_should_survive_reopening_and_drop_a_torn_record)
+        {
+            const char* path = "review_log_unit_test.bin";
+            std::remove(path);
+
+            StudySession live(strategy, 5, 5, 100);
+            LoadDeck(live);
+
+            {
+                ReviewLog log;
+                Assert::IsTrue(log.Open(path));
+                live.SetReviewLog(&log);
+                Answer(live, { ReviewOutcome::Perfect, ReviewOutcome::Incorrect, ReviewOutcome::Hesitant });
+                live.SetReviewLog(nullptr);
+            }
+
+            // -- half a record, as if the app died mid-write...
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::app);
+                file.write("\x01\x02\x03", 3);
+            }
+
+            ReviewLog reopened;
+            Assert::IsTrue(reopened.Open(path));
+            Assert::AreEqual(reopened.Size(), static_cast<size_t>(3));
+            Assert::AreEqual(reopened.Events()[1].outcome, static_cast<uint8_t>(ReviewOutcome::Incorrect));
+
+            Assert::IsTrue(reopened.Append(0, ReviewOutcome::Perfect, now));
+            reopened.Close();
+
+            ReviewLog again;
+            Assert::IsTrue(again.Open(path));
+            Assert::AreEqual(again.Size(), static_cast<size_t>(4));
+            again.Close();
+
+            std::remove(path);
+        }
+
+        TEST_METHOD(compaction_should_fold_the_log_into_a_snapshot_without_replaying_twice)
+        {
+            const char* path = "compacted_unit_test.bin";
+
+            ReviewLog log;
+            StudySession live(strategy, 5, 5, 100);
+            LoadDeck(live);
+            live.SetReviewLog(&log);
+            Answer(live, { ReviewOutcome::Incorrect, ReviewOutcome::Perfect });
+
+            // -- the answers logged before compaction, as if the app died before the log was cut...
+            ReviewLog uncut;
+            uncut.Truncate(log.FirstSequence());
+            for (const ReviewEvent& event : log.Events())
+            {
+                uncut.Append(event.card, static_cast<ReviewOutcome>(event.outcome), event.reviewedAt);
+            }
+
+            Assert::IsTrue(live.CompactReviewLog(path));
+            Assert::AreEqual(log.Size(), static_cast<size_t>(0));
+            Assert::AreEqual(log.FirstSequence(), 2U);
+
+            MappedSnapshot file;
+            Assert::IsTrue(file.Open(path));
+
+            StudySession fromUncut(strategy, 5, 5, 100);
+            Assert::IsTrue(fromUncut.Restore(file.Data(), file.Size(), uncut));
+            Assert::AreEqual(fromUncut.ReviewSequence(), 2U);
+
+            Answer(live, { ReviewOutcome::Hesitant });
+
+            StudySession fromCut(strategy, 5, 5, 100);
+            Assert::IsTrue(fromCut.Restore(file.Data(), file.Size(), log));
+
+            file.Close();
+            std::remove(path);
+
+            AssertStudiesTheSame(live, fromCut, now);
+        }
+
+        TEST_METHOD(failed_compaction_should_leave_the_old_snapshot_and_log_whole)
+        {
+            const char* path = "compaction_failure_unit_test.bin";
+            const char* logPath = "compaction_failure_unit_test.log";
+            std::remove(logPath);
+
+            ReviewLog log;
+            Assert::IsTrue(log.Open(logPath));
+
+            StudySession live(strategy, 5, 5, 100);
+            LoadDeck(live);
+            live.SetReviewLog(&log);
+            Answer(live, { ReviewOutcome::Incorrect });
+
+            Assert::IsTrue(live.CompactReviewLog(path));
+            Answer(live, { ReviewOutcome::Perfect, ReviewOutcome::Hesitant });
+
+            // -- nowhere to write the new snapshot, so the log has to keep its answers...
+            Assert::IsFalse(live.CompactReviewLog("no_such_directory/compacted.bin"));
+            Assert::AreEqual(log.Size(), static_cast<size_t>(2));
+
+            // -- and the last good snapshot, with no temporary file left next to it, still restores with the log...
+            Assert::IsTrue(std::ifstream(std::string(path) + ".tmp").fail());
+
+            ReviewLog reopened;
+            Assert::IsTrue(reopened.Open(logPath));
+            Assert::AreEqual(reopened.Size(), static_cast<size_t>(2));
+
+            MappedSnapshot file;
+            Assert::IsTrue(file.Open(path));
+
+            StudySession restored(strategy, 5, 5, 100);
+            Assert::IsTrue(restored.Restore(file.Data(), file.Size(), reopened));
+
+            file.Close();
+            live.SetReviewLog(nullptr);
+            log.Close();
+            reopened.Close();
+            std::remove(path);
+            std::remove(logPath);
+
+            AssertStudiesTheSame(live, restored, now);
+        }
+
+        TEST_METHOD(review_times_past_2106_should_survive_reopening)
+        {
+            const char* path = "review_log_64_bit_times_unit_test.bin";
+            const Timestamp past2106 = 5000000000U;
+
+            ReviewLog log;
+            Assert::IsTrue(log.Open(path));
+            Assert::IsTrue(log.Append(1, ReviewOutcome::Hesitant, now));
+            Assert::IsTrue(log.Append(4, ReviewOutcome::Perfect, past2106));
+            log.Close();
+
+            ReviewLog again;
+            Assert::IsTrue(again.Open(path));
+            Assert::AreEqual(again.Size(), static_cast<size_t>(2));
+            Assert::AreEqual(again.Events()[0].reviewedAt, now);
+            Assert::AreEqual(again.Events()[1].reviewedAt, past2106);
+            Assert::AreEqual(again.Events()[1].card, 4U);
+            again.Close();
+
+            std::remove(path);
+        }
+    };
+}
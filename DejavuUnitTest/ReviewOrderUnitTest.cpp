@@ -0,0 +1,91 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(ReviewOrderUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+        // -- four overdue cards, each first by one of the orders, and a new card that the cap of 0 keeps out...
+        void AddBacklog(SuperMemo2StudySession& session)
+        {
+            // -- due a day ago, six day interval...
+            session.AddPreviouslyFirstCorrect(10, now - 7 * day);
+            // -- due 14 days ago, six day interval, hardest...
+            session.AddPreviouslyFirstCorrect(90, now - 20 * day);
+            // -- due 2 days ago, one day interval...
+            session.AddPreviouslyCorrect(50, now - 3 * day, now - 5 * day);
+            // -- due 8 days ago, 22 day interval...
+            session.AddPreviouslyCorrect(0, now - 30 * day, now - 40 * day);
+            session.AddNeverReviewed();
+        }
+
+        std::vector<uint> StudyOrder(ReviewOrder order, uint existingCardMax)
+        {
+            SuperMemo2StudySession session(strategy, 0, existingCardMax, 100);
+            AddBacklog(session);
+            session.SetReviewOrder(order);
+
+            std::vector<uint> studied;
+
+            while (std::optional<uint> i = session.NextReview(now))
+            {
+                session.UpdateCard(*i, ReviewOutcome::Perfect, now);
+                studied.push_back(*i);
+            }
+
+            return studied;
+        }
+
+        static void AssertOrder(const std::vector<uint>& actual, const std::vector<uint>& expected)
+        {
+            Assert::AreEqual(actual.size(), expected.size());
+
+            for (size_t j = 0; j < expected.size(); j++)
+            {
+                Assert::AreEqual(actual[j], expected[j]);
+            }
+        }
+
+    public:
+        TEST_METHOD(each_order_should_hand_out_the_backlog_its_own_way)
+        {
+            AssertOrder(StudyOrder(ReviewOrder::RoundRobin, 4), { 0, 1, 2, 3 });
+            AssertOrder(StudyOrder(ReviewOrder::MostOverdue, 4), { 1, 3, 2, 0 });
+            AssertOrder(StudyOrder(ReviewOrder::HardestFirst, 4), { 1, 2, 0, 3 });
+            AssertOrder(StudyOrder(ReviewOrder::ShortestInterval, 4), { 2, 0, 1, 3 });
+        }
+
+        TEST_METHOD(capped_session_should_spend_its_slots_on_the_top_of_the_order)
+        {
+            AssertOrder(StudyOrder(ReviewOrder::MostOverdue, 2), { 1, 3 });
+            AssertOrder(StudyOrder(ReviewOrder::HardestFirst, 2), { 1, 2 });
+        }
+
+        TEST_METHOD(order_should_survive_a_snapshot_and_a_change_midway)
+        {
+            SuperMemo2StudySession session(strategy, 0, 4, 100);
+            AddBacklog(session);
+            session.SetReviewOrder(ReviewOrder::MostOverdue);
+
+            session.UpdateCard(session.NextReview(now).value(), ReviewOutcome::Perfect, now);
+
+            std::vector<uint8_t> snapshot;
+            session.SaveSnapshot(snapshot);
+
+            SuperMemo2StudySession restored(strategy, 0, 4, 100);
+            restored.SetReviewOrder(ReviewOrder::MostOverdue);
+            Assert::IsTrue(restored.LoadSnapshot(snapshot.data(), snapshot.size()));
+            Assert::AreEqual(restored.NextReview(now).value(), 3U);
+
+            restored.SetReviewOrder(ReviewOrder::ShortestInterval);
+            restored.UpdateCard(restored.NextReview(now).value(), ReviewOutcome::Perfect, now);
+            Assert::AreEqual(restored.NextReview(now).value(), 0U);
+        }
+    };
+}
@@ -0,0 +1,117 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+#include <map>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(SessionManagerUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+        // -- stands in for the server's storage: decks of user + 1 new cards, saved as snapshots once evicted...
+        uint loads = 0;
+        std::map<uint, std::vector<uint8_t>> saved;
+
+        bool Load(const SessionKey& key, StudySession& session)
+        {
+            loads++;
+
+            if (key.deck != 1)
+            {
+                return false;
+            }
+
+            auto snapshot = saved.find(key.user);
+
+            if (snapshot != saved.end())
+            {
+                return session.LoadSnapshot(snapshot->second.data(), snapshot->second.size());
+            }
+
+            for (uint i = 0; i <= key.user; i++)
+            {
+                session.AddNeverReviewed();
+            }
+
+            return true;
+        }
+
+        void Save(const SessionKey& key, StudySession& session)
+        {
+            session.SaveSnapshot(saved[key.user]);
+        }
+
+        std::unique_ptr<SessionManager> MakeManager(size_t memoryBudget)
+        {
+            return std::make_unique<SessionManager>(strategy, 5, 5, 1000, memoryBudget,
+                [this](const SessionKey& key, StudySession& session) { return Load(key, session); },
+                [this](const SessionKey& key, StudySession& session) { Save(key, session); });
+        }
+
+    public:
+        TEST_METHOD(each_learner_should_get_their_own_session_loaded_once)
+        {
+            auto manager = MakeManager(SIZE_MAX);
+
+            StudySession* first = manager->Acquire(SessionKey{ 1, 1 });
+            StudySession* second = manager->Acquire(SessionKey{ 2, 1 });
+
+            Assert::AreEqual(first->Size(), 2U);
+            Assert::AreEqual(second->Size(), 3U);
+            Assert::IsTrue(manager->Acquire(SessionKey{ 1, 1 }) == first);
+            Assert::AreEqual(loads, 2U);
+            Assert::AreEqual(manager->Size(), static_cast<size_t>(2));
+        }
+
+        TEST_METHOD(unknown_deck_should_not_be_loaded)
+        {
+            auto manager = MakeManager(SIZE_MAX);
+
+            Assert::IsTrue(manager->Acquire(SessionKey{ 1, 2 }) == nullptr);
+            Assert::AreEqual(manager->Size(), static_cast<size_t>(0));
+            Assert::AreEqual(manager->MemoryUsage(), static_cast<size_t>(0));
+        }
+
+        TEST_METHOD(least_recently_used_session_should_be_evicted_over_budget)
+        {
+            auto manager = MakeManager(SIZE_MAX);
+            manager->Acquire(SessionKey{ 1, 1 });
+            const size_t oneSession = manager->MemoryUsage();
+
+            // -- room for two sessions of this size, not three...
+            manager->SetMemoryBudget(2 * oneSession + oneSession / 2);
+
+            manager->Acquire(SessionKey{ 2, 1 });
+            manager->Acquire(SessionKey{ 1, 1 });
+            manager->Acquire(SessionKey{ 3, 1 });
+
+            Assert::IsTrue(manager->IsLoaded(SessionKey{ 1, 1 }));
+            Assert::IsFalse(manager->IsLoaded(SessionKey{ 2, 1 }));
+            Assert::IsTrue(manager->IsLoaded(SessionKey{ 3, 1 }));
+            Assert::IsTrue(manager->MemoryUsage() <= manager->MemoryBudget());
+            Assert::AreEqual(saved.count(2), static_cast<size_t>(1));
+        }
+
+        TEST_METHOD(evicted_session_should_come_back_with_its_answers)
+        {
+            auto manager = MakeManager(SIZE_MAX);
+
+            StudySession* session = manager->Acquire(SessionKey{ 1, 1 });
+            const uint index = session->NextReview(now).value();
+            session->UpdateCard(index, ReviewOutcome::Incorrect, now);
+
+            Assert::IsTrue(manager->Evict(SessionKey{ 1, 1 }));
+            Assert::IsFalse(manager->IsLoaded(SessionKey{ 1, 1 }));
+
+            session = manager->Acquire(SessionKey{ 1, 1 });
+
+            Assert::AreEqual(loads, 2U);
+            Assert::IsTrue(session->At(index).index() == static_cast<size_t>(CardState::PreviouslyIncorrect));
+            Assert::AreEqual(session->NextReview(now).value(), index + 1);
+        }
+    };
+}
@@ -0,0 +1,95 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    // -- passes everything on to the heap, counting as it goes...
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        uint allocations = 0;
+        uint deallocations = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            deallocations++;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    TEST_CLASS(SessionMemoryUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+        // -- every third answer wrong, so the wrong queue fills up too...
+        static void StudyThrough(SuperMemo2StudySession& session, Timestamp now)
+        {
+            uint n = 0;
+
+            while (std::optional<uint> i = session.NextReview(now))
+            {
+                session.UpdateCard(*i, (n++ % 3 == 0) ? ReviewOutcome::Incorrect : ReviewOutcome::Perfect, now);
+
+                if (n > 1000)
+                {
+                    break;
+                }
+            }
+        }
+
+    public:
+        TEST_METHOD(reserved_deck_should_fill_card_by_card_without_allocating)
+        {
+            CountingResource heap;
+            SuperMemo2StudySession session(strategy, 50, 50, 1000, &heap);
+
+            session.Reserve(500);
+            const uint allocations = heap.allocations;
+
+            for (uint i = 0; i < 500; i++)
+            {
+                session.AddNeverReviewed();
+            }
+
+            Assert::AreEqual(heap.allocations, allocations);
+        }
+
+        TEST_METHOD(reset_should_free_nothing_and_reloading_should_allocate_nothing)
+        {
+            CountingResource heap;
+            SuperMemo2StudySession session(strategy, 50, 50, 1000, &heap);
+            DeckRecordBuilder deck;
+            deck.WithMixedCards(400);
+
+            deck.ImportInto(session);
+            StudyThrough(session, now);
+
+            const uint allocations = heap.allocations;
+
+            session.Reset();
+            Assert::AreEqual(heap.deallocations, 0U);
+
+            deck.ImportInto(session);
+            StudyThrough(session, now);
+
+            Assert::AreEqual(heap.allocations, allocations);
+            Assert::AreEqual(heap.deallocations, 0U);
+        }
+    };
+}
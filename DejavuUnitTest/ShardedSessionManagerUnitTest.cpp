@@ -0,0 +1,198 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <random>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(ShardedSessionManagerUnitTest)
+    {
+        static constexpr uint learners = 32;
+        static constexpr uint threads = 8;
+        static constexpr uint answersPerThread = 2000;
+
+        SuperMemo2ReviewStrategy strategy;
+
+        // -- stands in for the server's storage, shared by every shard...
+        std::mutex storageMutex;
+        std::map<uint, std::vector<uint8_t>> saved;
+
+        bool Load(const SessionKey& key, StudySession& session)
+        {
+            std::lock_guard<std::mutex> guard(storageMutex);
+            auto snapshot = saved.find(key.user);
+
+            if (snapshot != saved.end())
+            {
+                return session.LoadSnapshot(snapshot->second.data(), snapshot->second.size());
+            }
+
+            for (uint i = 0; i < 20; i++)
+            {
+                session.AddNeverReviewed();
+            }
+
+            return true;
+        }
+
+        void Save(const SessionKey& key, StudySession& session)
+        {
+            std::vector<uint8_t> snapshot;
+            session.SaveSnapshot(snapshot);
+
+            std::lock_guard<std::mutex> guard(storageMutex);
+            saved[key.user] = std::move(snapshot);
+        }
+
+        std::unique_ptr<ShardedSessionManager> MakeManager(size_t memoryBudget, uint shardCount)
+        {
+            return std::make_unique<ShardedSessionManager>(strategy, 1000, 1000, 1000, memoryBudget, shardCount,
+                [this](const SessionKey& key, StudySession& session) { return Load(key, session); },
+                [this](const SessionKey& key, StudySession& session) { Save(key, session); });
+        }
+
+    public:
+        TEST_METHOD(answers_from_many_threads_should_all_land_one_learner_at_a_time)
+        {
+            // -- small enough a budget that sessions are evicted and reloaded all through the run...
+            auto manager = MakeManager(8 * 1024, 4);
+
+            std::vector<std::atomic<uint>> answers(learners);
+            std::vector<std::atomic<uint>> inside(learners);
+            std::atomic<bool> overlapped{ false };
+
+            std::vector<std::thread> workers;
+
+            for (uint t = 0; t < threads; t++)
+            {
+                workers.emplace_back([&, t]()
+                {
+                    std::mt19937 random(t);
+
+                    for (uint n = 0; n < answersPerThread; n++)
+                    {
+                        const uint user = random() % learners;
+                        const ReviewOutcome outcome = (random() % 3 == 0) ? ReviewOutcome::Incorrect : ReviewOutcome::Hesitant;
+
+                        manager->WithSession(SessionKey{ user, 1 }, [&](StudySession& session)
+                        {
+                            if (inside[user].fetch_add(1) != 0)
+                            {
+                                overlapped = true;
+                            }
+
+                            const std::optional<uint> i = session.NextReview(now);
+
+                            if (i)
+                            {
+                                session.UpdateCard(*i, outcome, now);
+                                answers[user]++;
+                            }
+
+                            inside[user]--;
+                        });
+                    }
+                });
+            }
+
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+
+            Assert::IsFalse(overlapped);
+
+            // -- every answer made it into its learner's session, through however many evictions...
+            for (uint user = 0; user < learners; user++)
+            {
+                uint sequence = 0;
+                manager->WithSession(SessionKey{ user, 1 }, [&sequence](StudySession& session) { sequence = session.ReviewSequence(); });
+
+                Assert::AreEqual(sequence, answers[user].load());
+            }
+        }
+
+        TEST_METHOD(convenience_calls_should_go_to_the_learners_session)
+        {
+            auto manager = MakeManager(SIZE_MAX, 4);
+
+            const uint first = manager->NextReview(SessionKey{ 7, 1 }, now).value();
+            const std::optional<uint> nextReviewTime = manager->UpdateCard(SessionKey{ 7, 1 }, first, ReviewOutcome::Perfect, now);
+
+            Assert::IsTrue(nextReviewTime.has_value());
+            Assert::AreEqual(manager->NextReview(SessionKey{ 7, 1 }, now).value(), first + 1);
+            Assert::AreEqual(manager->NextReview(SessionKey{ 8, 1 }, now).value(), 0U);
+            Assert::AreEqual(manager->Size(), static_cast<size_t>(2));
+        }
+
+        TEST_METHOD(work_that_throws_should_still_let_the_session_be_saved_and_evicted)
+        {
+            // -- room for just the session last worked on...
+            auto manager = MakeManager(1, 1);
+            bool threw = false;
+
+            try
+            {
+                manager->WithSession(SessionKey{ 3, 1 }, [this](StudySession& session)
+                {
+                    session.UpdateCard(0, ReviewOutcome::Perfect, now);
+                    throw std::runtime_error("work failed");
+                });
+            }
+            catch (const std::runtime_error&)
+            {
+                threw = true;
+            }
+
+            Assert::IsTrue(threw);
+
+            // -- a session left pinned would never leave, whatever the budget...
+            manager->WithSession(SessionKey{ 4, 1 }, [](StudySession&) {});
+
+            Assert::AreEqual(manager->Size(), static_cast<size_t>(1));
+            Assert::IsTrue(saved.count(3) == 1);
+
+            StudySession reloaded(strategy, 1000, 1000, 1000);
+            Assert::IsTrue(reloaded.LoadSnapshot(saved[3].data(), saved[3].size()));
+            Assert::AreEqual(reloaded.ReviewSequence(), 1U);
+        }
+
+        TEST_METHOD(slow_load_should_only_hold_up_its_own_learner)
+        {
+            std::promise<void> release;
+            std::shared_future<void> released = release.get_future().share();
+
+            // -- one shard, so both learners share a lock stripe...
+            ShardedSessionManager manager(strategy, 1000, 1000, 1000, SIZE_MAX, 1,
+                [this, released](const SessionKey& key, StudySession& session)
+                {
+                    if (key.user == 1)
+                    {
+                        released.wait();
+                    }
+
+                    return Load(key, session);
+                },
+                [this](const SessionKey& key, StudySession& session) { Save(key, session); });
+
+            auto slow = std::async(std::launch::async, [&manager, this]() { return manager.NextReview(SessionKey{ 1, 1 }, now); });
+            auto fast = std::async(std::launch::async, [&manager, this]() { return manager.NextReview(SessionKey{ 2, 1 }, now); });
+
+            const bool fastFinished = fast.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+
+            release.set_value();
+
+            Assert::IsTrue(fastFinished);
+            Assert::AreEqual(fast.get().value(), 0U);
+            Assert::AreEqual(slow.get().value(), 0U);
+        }
+    };
+}
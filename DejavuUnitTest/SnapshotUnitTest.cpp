@@ -0,0 +1,196 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(SnapshotUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+        // -- a deck with new, wrong, due and not yet due cards, part way through a session...
+        void StudyPartWay(StudySession& session)
+        {
+            session.AddNeverReviewed();
+            session.AddPreviouslyIncorrect(50, now - day);
+            session.AddPreviouslyFirstCorrect(50, now - 10 * day);
+            session.AddPreviouslyCorrect(50, now + 100 * day, now + 90 * day);
+            session.AddNeverReviewed();
+            session.AddPreviouslyFirstCorrect(50, now - day);
+
+            session.UpdateCard(session.NextReview(now).value(), ReviewOutcome::Incorrect, now);
+            session.UpdateCard(session.NextReview(now).value(), ReviewOutcome::Perfect, now);
+        }
+
+        // -- StudyPartWay, padded out with cards that come due over the next few weeks...
+        void StudyPartWayThroughBigDeck(StudySession& session, uint cards)
+        {
+            std::vector<DeckRecord> deck;
+
+            for (uint i = 0; i < cards; i++)
+            {
+                deck.push_back(DeckRecord{ CardState::PreviouslyFirstCorrect, 50, 0, now - 5 * day + (i % 50) * day, 0 });
+            }
+
+            session.ImportRecords(deck.data(), cards);
+            StudyPartWay(session);
+        }
+
+    public:
+        TEST_METHOD(loaded_snapshot_should_carry_on_where_the_session_left_off)
+        {
+            StudySession original(strategy, 5, 5, 100);
+            StudyPartWay(original);
+
+            std::vector<uint8_t> snapshot;
+            original.SaveSnapshot(snapshot);
+
+            StudySession loaded(strategy, 5, 5, 100);
+            Assert::IsTrue(loaded.LoadSnapshot(snapshot.data(), snapshot.size()));
+            Assert::IsTrue(loaded.DirtyCards().empty());
+
+            AssertStudiesTheSame(original, loaded, now);
+        }
+
+        TEST_METHOD(mapped_snapshot_file_should_load_like_the_image_it_was_written_from)
+        {
+            const char* path = "snapshot_unit_test.bin";
+
+            StudySession original(strategy, 5, 5, 100);
+            StudyPartWay(original);
+
+            std::vector<uint8_t> snapshot;
+            original.SaveSnapshot(snapshot);
+            Assert::IsTrue(WriteSnapshotFile(path, snapshot));
+
+            MappedSnapshot file;
+            Assert::IsTrue(file.Open(path));
+            Assert::AreEqual(file.Size(), snapshot.size());
+
+            StudySession loaded(strategy, 5, 5, 100);
+            Assert::IsTrue(loaded.LoadSnapshot(file.Data(), file.Size()));
+
+            file.Close();
+            std::remove(path);
+
+            AssertStudiesTheSame(original, loaded, now);
+        }
+
+        TEST_METHOD(borrowed_snapshot_should_study_like_a_loaded_one_without_copying_the_deck)
+        {
+            const uint cards = 2000;
+
+            StudySession original(strategy, 5, 5, 3000);
+            StudyPartWayThroughBigDeck(original, cards);
+
+            std::vector<uint8_t> snapshot;
+            original.SaveSnapshot(snapshot);
+
+            StudySession loaded(strategy, 5, 5, 3000);
+            Assert::IsTrue(loaded.LoadSnapshot(snapshot.data(), snapshot.size()));
+
+            StudySession borrowed(strategy, 5, 5, 3000);
+            Assert::IsTrue(borrowed.BorrowSnapshot(snapshot.data(), snapshot.size()));
+
+            // -- card columns, due times, visit states and pending cards all stay in the image...
+            const size_t perCard = sizeof(CardState) + sizeof(uint8_t) + 3 * sizeof(DeckTime) + sizeof(ReviewState) + sizeof(SnapshotPending);
+            Assert::IsTrue(borrowed.MemoryUsage() + cards * perCard <= loaded.MemoryUsage());
+
+            AssertStudiesTheSame(original, borrowed, now);
+        }
+
+        TEST_METHOD(snapshot_with_states_out_of_range_should_be_refused)
+        {
+            StudySession original(strategy, 5, 5, 100);
+            StudyPartWay(original);
+
+            std::vector<uint8_t> snapshot;
+            original.SaveSnapshot(snapshot);
+
+            SnapshotHeader header{};
+            std::memcpy(&header, snapshot.data(), sizeof(header));
+            const SnapshotLayout layout = ComputeSnapshotLayout(header);
+
+            for (const std::pair<size_t, uint8_t>& damage : { std::make_pair(layout.states, uint8_t(4)),
+                std::make_pair(layout.difficultyRatings, uint8_t(101)), std::make_pair(layout.visit, uint8_t(3)) })
+            {
+                std::vector<uint8_t> damaged(snapshot);
+                damaged[damage.first + 2] = damage.second;
+
+                StudySession loaded(strategy, 5, 5, 100);
+                Assert::IsFalse(loaded.LoadSnapshot(damaged.data(), damaged.size()));
+                Assert::IsFalse(loaded.BorrowSnapshot(damaged.data(), damaged.size()));
+                Assert::AreEqual(loaded.Size(), 0U);
+            }
+        }
+
+        TEST_METHOD(truncated_or_foreign_snapshot_should_be_refused)
+        {
+            StudySession original(strategy, 5, 5, 100);
+            StudyPartWay(original);
+
+            std::vector<uint8_t> snapshot;
+            original.SaveSnapshot(snapshot);
+
+            StudySession loaded(strategy, 5, 5, 100);
+            Assert::IsFalse(loaded.LoadSnapshot(snapshot.data(), snapshot.size() - 8));
+            Assert::AreEqual(loaded.Size(), 0U);
+
+            snapshot[4] = SnapshotVersion + 1;
+            Assert::IsFalse(loaded.LoadSnapshot(snapshot.data(), snapshot.size()));
+
+            StudySession tooSmall(strategy, 5, 5, 2);
+            snapshot[4] = SnapshotVersion;
+            Assert::IsFalse(tooSmall.LoadSnapshot(snapshot.data(), snapshot.size()));
+        }
+
+        TEST_METHOD(session_should_carry_on_past_2106_and_snapshot_its_epoch)
+        {
+            const Timestamp late = 4294000000U;
+            const Timestamp past2106 = late + 30 * day;
+
+            StudySession original(strategy, 5, 5, 100);
+            original.AddPreviouslyFirstCorrect(50, late - 10 * day);
+            original.AddNeverReviewed();
+
+            // -- the answer no longer fits 32 bits from the unix epoch, so the deck moves its epoch...
+            const uint first = original.NextReview(past2106).value();
+            const Timestamp nextReview = original.UpdateCard(first, ReviewOutcome::Perfect, past2106).value();
+
+            Assert::AreEqual(first, 0U);
+            Assert::IsTrue(nextReview > past2106);
+            Assert::AreEqual(original.GetNextReviewTime(first, past2106), nextReview);
+            Assert::AreEqual(std::get<PreviouslyCorrect>(original.At(first)).previousCorrectReview, late - 10 * day);
+
+            std::vector<uint8_t> snapshot;
+            original.SaveSnapshot(snapshot);
+
+            StudySession loaded(strategy, 5, 5, 100);
+            Assert::IsTrue(loaded.LoadSnapshot(snapshot.data(), snapshot.size()));
+
+            AssertStudiesTheSame(original, loaded, past2106);
+        }
+
+        TEST_METHOD(dates_too_far_from_the_deck_should_be_refused_and_leave_it_as_it_was)
+        {
+            const Timestamp tooFar = now + (Timestamp(1) << 32);
+
+            StudySession session(strategy, 5, 5, 100);
+            Assert::IsTrue(session.AddPreviouslyFirstCorrect(50, now - 10 * day));
+            Assert::IsFalse(session.AddPreviouslyIncorrect(50, tooFar));
+            Assert::AreEqual(session.Size(), 1U);
+
+            const Timestamp due = session.GetNextReviewTime(0, now);
+
+            Assert::IsFalse(session.UpdateCard(0, ReviewOutcome::Perfect, tooFar).has_value());
+            Assert::AreEqual(session.GetNextReviewTime(0, now), due);
+            Assert::AreEqual(session.ReviewSequence(), 0U);
+            Assert::IsTrue(std::holds_alternative<PreviouslyFirstCorrect>(session.At(0)));
+        }
+    };
+}
@@ -0,0 +1,100 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(StatsUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+        static uint64_t Total(const uint64_t* histogram)
+        {
+            uint64_t total = 0;
+
+            for (uint b = 0; b < StatHistogramBuckets; b++)
+            {
+                total += histogram[b];
+            }
+
+            return total;
+        }
+
+    public:
+        TEST_METHOD(bucket_should_be_the_bit_width_of_the_value)
+        {
+            Assert::AreEqual(StatBucket(0), 0U);
+            Assert::AreEqual(StatBucket(1), 1U);
+            Assert::AreEqual(StatBucket(2), 2U);
+            Assert::AreEqual(StatBucket(3), 2U);
+            Assert::AreEqual(StatBucket(1024), 11U);
+            Assert::AreEqual(StatBucket(UINT64_MAX), StatHistogramBuckets - 1);
+        }
+
+        TEST_METHOD(stats_should_count_every_call_when_enabled_and_nothing_when_not)
+        {
+            SuperMemo2StudySession session(strategy, 5, 5, 100);
+            session.AddNeverReviewed();
+            session.AddNeverReviewed();
+            session.AddPreviouslyCorrect(DifficultyRatingEasiest, now - 2 * day, now - 12 * day);
+
+            ResetStats();
+
+            uint answered = 0;
+
+            while (std::optional<uint> i = session.NextReview(now))
+            {
+                session.UpdateCard(*i, ReviewOutcome::Perfect, now);
+                answered++;
+            }
+
+            DejavuStats stats;
+            GetStats(stats);
+
+            const uint64_t expected = StatsEnabled ? 1 : 0;
+
+            Assert::AreEqual(answered, 2U);
+            Assert::AreEqual(stats.Counter(StatCounter::NextReviewCalls), expected * (answered + 1));
+            Assert::AreEqual(stats.Counter(StatCounter::UpdateCardCalls), expected * answered);
+            Assert::AreEqual(stats.Counter(StatCounter::StrategyAdjustDifficultyCalls), expected * answered);
+            Assert::AreEqual(Total(stats.Histogram(StatHistogram::NextReviewNanoseconds)), expected * (answered + 1));
+            Assert::AreEqual(Total(stats.Histogram(StatHistogram::UpdateCardNanoseconds)), expected * answered);
+            Assert::AreEqual(Total(stats.Histogram(StatHistogram::NextReviewCardsScanned)), expected * (answered + 1));
+
+            // -- both new cards were popped off the pending heap and then picked, the future card never came up...
+            Assert::AreEqual(stats.Counter(StatCounter::CardsScanned), expected * 4);
+            Assert::AreEqual(stats.Counter(StatCounter::DueHits), expected * answered);
+            Assert::AreEqual(stats.Counter(StatCounter::DueMisses), 0ULL);
+        }
+
+        TEST_METHOD(due_misses_should_count_each_card_turned_away)
+        {
+            SuperMemo2StudySession session(strategy, 5, 5, 100);
+            session.AddNeverReviewed();
+            session.AddPreviouslyCorrect(DifficultyRatingEasiest, now - 2 * day, now - 12 * day);
+
+            const Timestamp later = session.GetNextReviewTime(1, now);
+
+            ResetStats();
+
+            // -- too early to promote, then promoted and asked for before its time once the new card is gone...
+            Assert::IsFalse(session.PromoteCard(1, now));
+            Assert::IsTrue(session.PromoteCard(1, later));
+            Assert::AreEqual(session.NextReview(now).value(), 0U);
+            session.UpdateCard(0, ReviewOutcome::Perfect, now);
+            Assert::IsFalse(session.NextReview(now).has_value());
+            Assert::AreEqual(session.NextReview(later).value(), 1U);
+
+            DejavuStats stats;
+            GetStats(stats);
+
+            const uint64_t expected = StatsEnabled ? 1 : 0;
+
+            Assert::AreEqual(stats.Counter(StatCounter::DueHits), expected * 2);
+            Assert::AreEqual(stats.Counter(StatCounter::DueMisses), expected * 2);
+        }
+    };
+}
@@ -1,6 +1,8 @@
 #include "CppUnitTest.h"
 #include "..\Dejavu\Dejavu.h"
 #include "DejavuUnitTest.h"
+#include "..\Dejavu\SuperMemo2Tables.h"
+#include <random>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace jlimdev;
@@ -9,7 +11,7 @@ namespace FlashcardUnitTest
 {
     TEST_CLASS(StrategyUnitTest)
     {
-        uint now;
+        Timestamp now;
         SuperMemo2ReviewStrategy strategy;
         std::unique_ptr<StudySession> session;
 
@@ -20,7 +22,7 @@ namespace FlashcardUnitTest
         TEST_METHOD_INITIALIZE(setup_session_and_strategy)
         {
             // method initialization code
-            now = static_cast<int>(time(nullptr));
+            now = static_cast<Timestamp>(time(nullptr));
             session = std::make_unique<StudySession>(strategy, maxNewCardsInSession, maxExistingCardsInSession, maxCards);
         }
 
@@ -149,6 +151,164 @@ namespace FlashcardUnitTest
             Assert::AreEqual(actualDifficulty, expectedDifficulty);
         }
 
+        TEST_METHOD(difficulty_lookup_matches_formula_for_every_rating_and_outcome)
+        {
+            const ReviewOutcome outcomes[] = { ReviewOutcome::Perfect, ReviewOutcome::Hesitant, ReviewOutcome::Incorrect, ReviewOutcome::NeverReviewed };
+
+            for (DifficultyRating rating = DifficultyRatingEasiest; rating <= DifficultyRatingMostDifficult; rating++)
+            {
+                for (const ReviewOutcome outcome : outcomes)
+                {
+                    const ReviewItem item = PreviouslyCorrect{ rating, now, now - Days(11) };
+
+                    Assert::AreEqual(strategy.AdjustDifficulty(item, outcome), SuperMemo2ReviewStrategy::AdjustDifficultyRating(rating, outcome));
+                }
+            }
+        }
+
+        TEST_METHOD(difficulty_table_matches_values_worked_out_by_hand)
+        {
+            // -- rather than from the formula the table is built with: easiness moves by +0.1, 0, -0.14 and -0.32 for
+            // -- perfect, hesitant, incorrect and never reviewed, which is -8.33, 0, +11.67 and +26.67 rating,
+            // -- truncated and clamped to 0..100. a hesitant answer can land one below where it started, from rounding...
+            struct ExpectedAdjustment
+            {
+                uint rating;
+                uint perfect;
+                uint hesitant;
+                uint incorrect;
+                uint neverReviewed;
+            };
+
+            const ExpectedAdjustment expectedAdjustments[] = {
+                { 0, 0, 0, 11, 26 },
+                { 1, 0, 1, 12, 27 },
+                { 10, 1, 10, 21, 36 },
+                { 25, 16, 24, 36, 51 },
+                { 49, 40, 49, 60, 75 },
+                { 50, 41, 50, 61, 76 },
+                { 75, 66, 74, 86, 100 },
+                { 90, 81, 90, 100, 100 },
+                { 99, 90, 99, 100, 100 },
+                { 100, 91, 100, 100, 100 },
+            };
+
+            for (const ExpectedAdjustment& expected : expectedAdjustments)
+            {
+                const uint row = expected.rating * ReviewOutcomeCount;
+
+                Assert::AreEqual(static_cast<uint>(AdjustDifficultyTable[row + static_cast<uint>(ReviewOutcome::Perfect)]), expected.perfect);
+                Assert::AreEqual(static_cast<uint>(AdjustDifficultyTable[row + static_cast<uint>(ReviewOutcome::Hesitant)]), expected.hesitant);
+                Assert::AreEqual(static_cast<uint>(AdjustDifficultyTable[row + static_cast<uint>(ReviewOutcome::Incorrect)]), expected.incorrect);
+                Assert::AreEqual(static_cast<uint>(AdjustDifficultyTable[row + static_cast<uint>(ReviewOutcome::NeverReviewed)]), expected.neverReviewed);
+            }
+        }
+
+        TEST_METHOD(easiness_table_runs_from_2_5_down_to_1_3)
+        {
+            Assert::AreEqual(EasinessFactorTable[0], 2.5, 1e-9);
+            Assert::AreEqual(EasinessFactorTable[25], 2.2, 1e-9);
+            Assert::AreEqual(EasinessFactorTable[50], 1.9, 1e-9);
+            Assert::AreEqual(EasinessFactorTable[99], 1.312, 1e-9);
+            Assert::AreEqual(EasinessFactorTable[100], 1.3, 1e-9);
+        }
+
+        TEST_METHOD(batch_schedule_matches_one_card_at_a_time)
+        {
+            const ReviewItem items[] = {
+                NeverReviewed{ DifficultyRatingMostDifficult },
+                PreviouslyIncorrect{ 61, now - Days(1) },
+                PreviouslyFirstCorrect{ 50, now - Days(2) },
+                PreviouslyCorrect{ DifficultyRatingEasiest, now, now - Days(11) },
+                PreviouslyCorrect{ DifficultyRatingMostDifficult, now - Days(3), now - Days(20) }
+            };
+            constexpr size_t count = sizeof(items) / sizeof(items[0]);
+            Timestamp batch[count];
+
+            strategy.NextReviewBatch(items, count, now, batch);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                Assert::AreEqual(batch[i], strategy.NextReview(items[i], now));
+            }
+        }
+
+        TEST_METHOD(vector_kernel_matches_scalar_schedule_bit_for_bit)
+        {
+            // -- odd count so the scalar tail gets exercised too...
+            constexpr size_t count = 1003;
+            std::mt19937 random(20200101);
+            std::uniform_int_distribution<uint> rating(DifficultyRatingEasiest, DifficultyRatingMostDifficult);
+            std::uniform_int_distribution<uint> timestamp(0, UINT32_MAX);
+            std::uniform_int_distribution<uint> gap(Days(1), UINT32_MAX);
+
+            std::vector<uint8_t> difficultyRating(count);
+            std::vector<DeckTime> reviewDate(count);
+            std::vector<DeckTime> previousCorrectReview(count);
+            std::vector<DeckTime> vectorized(count);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                difficultyRating[i] = static_cast<uint8_t>(rating(random));
+                previousCorrectReview[i] = timestamp(random);
+                reviewDate[i] = previousCorrectReview[i] + gap(random);
+            }
+
+            SuperMemo2ReviewStrategy::NextReviewPreviouslyCorrect(difficultyRating.data(), reviewDate.data(),
+                previousCorrectReview.data(), count, vectorized.data());
+
+            for (size_t i = 0; i < count; i++)
+            {
+                const ReviewItem item = PreviouslyCorrect{ difficultyRating[i], reviewDate[i], previousCorrectReview[i] };
+
+                // -- deck times are 32 bits, so dates past the end of them are held at the last one...
+                Assert::AreEqual(vectorized[i], static_cast<DeckTime>(std::min<Timestamp>(strategy.NextReview(item, now), DeckTimeMax)));
+            }
+        }
+
+        TEST_METHOD(column_schedule_matches_one_card_at_a_time)
+        {
+            CardStore cards;
+
+            for (uint i = 0; i < 300; i++)
+            {
+                cards.Add(NeverReviewed{ DifficultyRatingMostDifficult });
+                cards.Add(PreviouslyIncorrect{ i % 101, now - Days(i % 7) });
+                cards.Add(PreviouslyFirstCorrect{ i % 101, now - Days(i % 9) });
+                cards.Add(PreviouslyCorrect{ i % 101, now - Days(i % 5), now - Days(i % 5 + 1 + i % 30) });
+            }
+
+            std::vector<DeckTime> columns(cards.Size());
+            strategy.NextReviewColumns(cards, 0, cards.Size(), cards.ToDeckTime(now), columns.data());
+
+            for (uint i = 0; i < cards.Size(); i++)
+            {
+                Assert::AreEqual(cards.FromDeckTime(columns[i]), strategy.NextReview(cards.At(i), now));
+            }
+        }
+
+        TEST_METHOD(column_schedule_should_hold_due_times_past_the_end_of_deck_time_at_the_last_one)
+        {
+            const Timestamp end = DeckTimeMax;
+            CardStore cards;
+
+            // -- enough PreviouslyCorrect cards for the vector kernel and its tail...
+            for (uint i = 0; i < 9; i++)
+            {
+                cards.Add(PreviouslyFirstCorrect{ 50, end - Days(i % 6) });
+                cards.Add(PreviouslyCorrect{ i * 10, end - Days(i), end - Days(i + 30) });
+            }
+
+            std::vector<DeckTime> columns(cards.Size());
+            strategy.NextReviewColumns(cards, 0, cards.Size(), cards.ToDeckTime(end - Days(10)), columns.data());
+
+            for (uint i = 0; i < cards.Size(); i++)
+            {
+                Assert::AreEqual(columns[i], cards.ToDeckTime(strategy.NextReview(cards.At(i), end - Days(10))));
+                Assert::AreEqual(columns[i], DeckTimeMax);
+            }
+        }
+
         Timestamp Days(uint count)
         {
             return count * 24 * 60 * 60;
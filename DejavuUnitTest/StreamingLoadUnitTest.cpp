@@ -0,0 +1,128 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(StreamingLoadUnitTest)
+    {
+        SuperMemo2ReviewStrategy strategy;
+
+        // -- imports chunkSize records of deck at a time, from wherever the session has got to...
+        static SuperMemo2StudySession::ChunkLoader Loader(const std::vector<DeckRecord>& deck, uint chunkSize, uint& calls)
+        {
+            return [&deck, chunkSize, &calls](SuperMemo2StudySession& session)
+            {
+                calls++;
+
+                const uint first = session.Size();
+                const uint count = std::min(chunkSize, static_cast<uint>(deck.size()) - first);
+
+                return session.ImportRecords(deck.data() + first, count) == count;
+            };
+        }
+
+    public:
+        TEST_METHOD(first_card_should_come_from_the_first_chunk)
+        {
+            const std::vector<DeckRecord> deck = DeckRecordBuilder().WithMixedCards(1000).Build();
+            SuperMemo2StudySession session(strategy, 20, 200, 1000);
+
+            session.StreamDeck(static_cast<uint>(deck.size()));
+            session.ImportRecords(deck.data(), 50);
+
+            Assert::IsFalse(session.FullyLoaded());
+            Assert::AreEqual(session.StreamedSize(), 1000U);
+            Assert::AreEqual(session.NextReview(now).value(), 0U);
+
+            session.ImportRecords(deck.data() + 50, 950);
+            Assert::IsTrue(session.FullyLoaded());
+        }
+
+        TEST_METHOD(streamed_deck_should_be_studied_in_the_same_order_as_a_loaded_one)
+        {
+            const std::vector<DeckRecord> deck = DeckRecordBuilder().WithMixedCards(300).Build();
+
+            SuperMemo2StudySession loaded(strategy, 20, 60, 300);
+            loaded.ImportRecords(deck.data(), static_cast<uint>(deck.size()));
+
+            uint calls = 0;
+            SuperMemo2StudySession streamed(strategy, 20, 60, 300);
+            streamed.StreamDeck(static_cast<uint>(deck.size()), Loader(deck, 16, calls));
+            streamed.LoadNextChunk();
+
+            Timestamp time = now;
+            uint n = 0;
+
+            for (;;)
+            {
+                const std::optional<uint> expected = loaded.NextReview(time);
+                const std::optional<uint> actual = streamed.NextReview(time);
+
+                // -- only as much of the deck as it takes to find the first card...
+                if (n == 0)
+                {
+                    Assert::AreEqual(streamed.Size(), 16U);
+                }
+
+                Assert::AreEqual(actual.has_value(), expected.has_value());
+
+                if (!expected)
+                {
+                    break;
+                }
+
+                Assert::AreEqual(*actual, *expected);
+
+                const ReviewOutcome outcome = (n++ % 5 == 0) ? ReviewOutcome::Incorrect : ReviewOutcome::Perfect;
+                loaded.UpdateCard(*expected, outcome, time);
+                streamed.UpdateCard(*actual, outcome, time);
+                time += 30;
+            }
+
+            // -- both caps ran out part way through the deck, and nothing more was loaded once they had...
+            Assert::IsFalse(streamed.FullyLoaded());
+            Assert::AreEqual(calls, 8U);
+        }
+
+        TEST_METHOD(used_up_caps_should_stop_loading_chunks)
+        {
+            const std::vector<DeckRecord> deck = DeckRecordBuilder().WithMixedCards(1000).Build();
+            SuperMemo2StudySession session(strategy, 1, 1, 1000);
+
+            uint calls = 0;
+            session.StreamDeck(static_cast<uint>(deck.size()), Loader(deck, 50, calls));
+
+            Assert::AreEqual(session.NextReview(now).value(), 0U);
+            session.UpdateCard(0, ReviewOutcome::Perfect, now);
+            Assert::AreEqual(session.NextReview(now).value(), 1U);
+            session.UpdateCard(1, ReviewOutcome::Perfect, now);
+
+            Assert::IsFalse(session.NextReview(now).has_value());
+            Assert::AreEqual(session.Size(), 50U);
+            Assert::AreEqual(calls, 1U);
+        }
+
+        TEST_METHOD(loader_that_runs_dry_should_end_the_stream)
+        {
+            const std::vector<DeckRecord> deck = DeckRecordBuilder().WithMixedCards(40).Build();
+            SuperMemo2StudySession session(strategy, 20, 200, 1000);
+
+            uint calls = 0;
+            session.StreamDeck(500, Loader(deck, 32, calls));
+
+            while (std::optional<uint> i = session.NextReview(now))
+            {
+                session.UpdateCard(*i, ReviewOutcome::Perfect, now);
+            }
+
+            Assert::IsTrue(session.FullyLoaded());
+            Assert::AreEqual(session.Size(), 40U);
+            Assert::IsFalse(session.LoadNextChunk());
+            Assert::AreEqual(calls, 3U);
+        }
+    };
+}
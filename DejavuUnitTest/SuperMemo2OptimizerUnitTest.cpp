@@ -0,0 +1,167 @@
+#include "CppUnitTest.h"
+#include "..\Dejavu\Dejavu.h"
+#include "DejavuUnitTest.h"
+#include <cmath>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace jlimdev;
+
+namespace FlashcardUnitTest
+{
+    TEST_CLASS(SuperMemo2OptimizerUnitTest)
+    {
+        // -- learners whose memory really follows the given constants: each answer comes somewhere between half and
+        // -- twice the interval those constants schedule, and is right with probability 0.9 ^ (elapsed / interval)...
+        ReviewHistories Simulate(const SuperMemo2Parameters& truth, uint cards, uint answersPerCard)
+        {
+            const ParameterizedSuperMemo2ReviewStrategy strategy(truth);
+            std::mt19937 random(17);
+            std::uniform_real_distribution<double> lateness(0.5, 2.0);
+            std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+            ReviewHistories histories;
+
+            for (uint card = 0; card < cards; card++)
+            {
+                ReviewItem item = NeverReviewed{ DifficultyRatingMostDifficult };
+                Timestamp now = 1600000000U;
+
+                for (uint n = 0; n < answersPerCard; n++)
+                {
+                    const bool scheduled = std::holds_alternative<PreviouslyFirstCorrect>(item) || std::holds_alternative<PreviouslyCorrect>(item);
+                    const double interval = scheduled ? std::max<double>(static_cast<int>(strategy.NextReview(item, now) - now), day) : day;
+                    const Timestamp elapsed = (n == 0) ? 0 : static_cast<Timestamp>(interval * lateness(random));
+                    const bool correct = (n == 0) || chance(random) < std::pow(0.9, elapsed / interval);
+                    const ReviewOutcome outcome = correct ? ReviewOutcome::Hesitant : ReviewOutcome::Incorrect;
+
+                    now += elapsed;
+                    histories.AddAnswer(outcome, elapsed);
+
+                    const DifficultyRating rating = strategy.AdjustDifficulty(item, outcome);
+
+                    if (!correct)
+                    {
+                        item = PreviouslyIncorrect{ rating, now };
+                    }
+                    else if (std::holds_alternative<PreviouslyFirstCorrect>(item))
+                    {
+                        item = PreviouslyCorrect{ rating, now, std::get<PreviouslyFirstCorrect>(item).reviewDate };
+                    }
+                    else if (std::holds_alternative<PreviouslyCorrect>(item))
+                    {
+                        item = PreviouslyCorrect{ rating, now, std::get<PreviouslyCorrect>(item).reviewDate };
+                    }
+                    else
+                    {
+                        item = PreviouslyFirstCorrect{ rating, now };
+                    }
+                }
+
+                histories.EndCard();
+            }
+
+            return histories;
+        }
+
+    public:
+        TEST_METHOD(default_parameters_should_schedule_exactly_like_super_memo_2)
+        {
+            const SuperMemo2ReviewStrategy superMemo2;
+            const ParameterizedSuperMemo2ReviewStrategy parameterized;
+
+            for (uint rating = 0; rating <= DifficultyRatingMostDifficult; rating++)
+            {
+                const ReviewItem items[] = {
+                    NeverReviewed{ rating },
+                    PreviouslyIncorrect{ rating, now - day },
+                    PreviouslyFirstCorrect{ rating, now - 3 * day },
+                    PreviouslyCorrect{ rating, now - 2 * day, now - (2 + rating % 40) * day },
+                };
+
+                for (const ReviewItem& item : items)
+                {
+                    Assert::AreEqual(parameterized.NextReview(item, now), superMemo2.NextReview(item, now));
+
+                    for (const ReviewOutcome outcome : { ReviewOutcome::Perfect, ReviewOutcome::Hesitant, ReviewOutcome::Incorrect })
+                    {
+                        Assert::AreEqual(parameterized.AdjustDifficulty(item, outcome), superMemo2.AdjustDifficulty(item, outcome));
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(review_log_should_group_into_one_history_per_card)
+        {
+            ReviewLog log;
+            log.Append(3, ReviewOutcome::Perfect, 1000);
+            log.Append(1, ReviewOutcome::Incorrect, 1100);
+            log.Append(3, ReviewOutcome::Hesitant, 1500);
+            log.Append(1, ReviewOutcome::Perfect, 1200);
+
+            const ReviewHistories histories = HistoriesFromReviewLog(log.Events());
+
+            Assert::AreEqual(histories.Cards(), static_cast<size_t>(2));
+            Assert::AreEqual(histories.cardStart[1], 2U);
+
+            // -- card 1 first...
+            Assert::AreEqual(histories.outcome[0], static_cast<uint8_t>(ReviewOutcome::Incorrect));
+            Assert::AreEqual(histories.elapsed[0], static_cast<Timestamp>(0));
+            Assert::AreEqual(histories.elapsed[1], static_cast<Timestamp>(100));
+            Assert::AreEqual(histories.elapsed[3], static_cast<Timestamp>(500));
+        }
+
+        TEST_METHOD(loss_should_follow_the_forgetting_curve_however_far_apart_the_answers)
+        {
+            // -- each card right once, then answered again a while later against the 6 day first interval.
+            // -- seven cards, so the loss is worked out partly four at a time and partly one at a time...
+            const Timestamp elapsed[] = { 1, day / 2, 3 * day, 6 * day, 13 * day, 400 * day, 100000 * day };
+
+            ReviewHistories histories;
+            double expected = 0;
+
+            for (size_t card = 0; card < std::size(elapsed); card++)
+            {
+                const bool recalled = card % 2 == 0;
+
+                histories.AddAnswer(ReviewOutcome::Perfect, 0);
+                histories.AddAnswer(recalled ? ReviewOutcome::Perfect : ReviewOutcome::Incorrect, elapsed[card]);
+                histories.EndCard();
+
+                const double error = std::pow(0.9, static_cast<double>(elapsed[card]) / (6 * day)) - (recalled ? 1.0 : 0.0);
+                expected += error * error;
+            }
+
+            expected /= std::size(elapsed);
+
+            Assert::AreEqual(SuperMemo2Loss(SuperMemo2Parameters(), histories), expected, 1e-9);
+        }
+
+        TEST_METHOD(fit_should_beat_the_default_constants_on_learners_who_follow_other_ones)
+        {
+            SuperMemo2Parameters truth;
+            truth.easinessIntercept = 1.9;
+            truth.firstIntervalDays = 3.0;
+
+            const ReviewHistories histories = Simulate(truth, 1500, 8);
+
+            SuperMemo2FitSettings settings;
+            settings.rounds = 25;
+            settings.candidatesPerRound = 16;
+            settings.threads = 4;
+
+            double fittedLoss = 0;
+            const SuperMemo2Parameters fitted = FitSuperMemo2Parameters(histories, SuperMemo2Parameters(), settings, &fittedLoss);
+            const double defaultLoss = SuperMemo2Loss(SuperMemo2Parameters(), histories);
+
+            Assert::IsTrue(fittedLoss < defaultLoss);
+            Assert::AreEqual(fittedLoss, SuperMemo2Loss(fitted, histories));
+            Assert::IsTrue(std::abs(fitted.firstIntervalDays - truth.firstIntervalDays) < std::abs(6.0 - truth.firstIntervalDays));
+
+            // -- the search is seeded, so the thread count doesn't change the answer...
+            settings.threads = 1;
+            const SuperMemo2Parameters again = FitSuperMemo2Parameters(histories, SuperMemo2Parameters(), settings);
+            Assert::AreEqual(again.firstIntervalDays, fitted.firstIntervalDays);
+        }
+    };
+}
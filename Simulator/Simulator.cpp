@@ -0,0 +1,300 @@
+// Monte-Carlo workload simulator: synthetic learners study synthetic decks day after day, once with each strategy,
+// and we report reviews per day, the backlog left over at the end of each day and NextReview + UpdateCard calls per second.
+//
+// every learner studies one session a day: the deck is imported, studied until NextReview runs dry, and exported back.
+// answers come from a forgetting curve, recall = retention ^ (days since last review / stability), with stability growing
+// on every correct answer and starting over on a wrong one. learners are independent, so they are spread over all cores.
+//
+// build with Simulator.vcxproj from Dejavu.sln, or with the benchmarks from the repo root:
+//   cmake -S Benchmark -B build/benchmark -DCMAKE_BUILD_TYPE=Release
+//   cmake --build build/benchmark --target DejavuSimulator
+// run:
+//   build/benchmark/DejavuSimulator [learners=1000] [days=60] [cards=500]
+
+#include "Dejavu.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+using namespace jlimdev;
+
+constexpr Timestamp start = 1600000000U;
+constexpr Timestamp day = 24 * 60 * 60;
+
+// -- how a simulated learner answers...
+struct AnswerModel
+{
+    double newCardRecall = 0.4;      // chance of knowing a card the first time it is shown
+    double retention = 0.9;          // recall after stability days have passed
+    double initialStability = 1.0;   // days, after the first exposure or a lapse
+    double stabilityGrowth = 2.5;    // stability multiplier on a correct answer, scaled by the card's ease
+    double hesitantShare = 0.3;      // correct answers that were hesitant rather than perfect
+};
+
+// -- daily limits a session is opened with...
+struct SessionLimits
+{
+    uint newCards = 20;
+    uint existingCards = 200;
+};
+
+/// <summary>
+/// Builds a synthetic starting deck, the same way ReviewItemBuilder fills a test session.
+/// </summary>
+class DeckBuilder
+{
+    std::vector<DeckRecord> deck;
+    Timestamp now;
+
+public:
+    explicit DeckBuilder(Timestamp now) : now(now)
+    {
+    }
+
+    DeckBuilder& WithNewCards(uint count)
+    {
+        for (uint i = 0; i < count; i++)
+        {
+            deck.push_back(DeckRecord{ CardState::NeverReviewed, DifficultyRatingMostDifficult, 0, 0, 0 });
+        }
+
+        return *this;
+    }
+
+    DeckBuilder& WithDueCards(uint count, uint8_t difficultyRating)
+    {
+        for (uint i = 0; i < count; i++)
+        {
+            deck.push_back(DeckRecord{ CardState::PreviouslyCorrect, difficultyRating, 0, now - 10 * day - 1, now - 12 * day });
+        }
+
+        return *this;
+    }
+
+    DeckBuilder& WithFutureCards(uint count, uint8_t difficultyRating)
+    {
+        for (uint i = 0; i < count; i++)
+        {
+            deck.push_back(DeckRecord{ CardState::PreviouslyCorrect, difficultyRating, 0, now - 2 * day, now - 12 * day });
+        }
+
+        return *this;
+    }
+
+    std::vector<DeckRecord> Build() const
+    {
+        return deck;
+    }
+};
+
+// -- what the learner really remembers of a card, which the strategy only gets to see through the answers...
+struct CardMemory
+{
+    double stability;
+    double ease;
+    Timestamp lastReview;
+};
+
+struct DayStats
+{
+    uint64_t reviews = 0;
+    uint64_t correct = 0;
+    uint64_t backlog = 0;
+    uint64_t calls = 0;
+};
+
+ReviewOutcome Answer(const AnswerModel& model, CardMemory& memory, Timestamp now, std::mt19937& random)
+{
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    const double recall = (memory.lastReview == 0)
+        ? model.newCardRecall
+        : std::pow(model.retention, static_cast<double>(now - memory.lastReview) / day / memory.stability);
+
+    const bool known = chance(random) < recall;
+
+    // -- answering right after being shown the card doesn't make it stick any better...
+    if (known && memory.lastReview != 0 && now - memory.lastReview >= day / 2)
+    {
+        memory.stability *= model.stabilityGrowth * memory.ease;
+    }
+    else if (!known)
+    {
+        memory.stability = model.initialStability;
+    }
+
+    memory.lastReview = now;
+
+    if (!known)
+    {
+        return ReviewOutcome::Incorrect;
+    }
+
+    return (chance(random) < model.hesitantShare) ? ReviewOutcome::Hesitant : ReviewOutcome::Perfect;
+}
+
+// -- one learner over the whole run, adding into stats, one entry per day...
+void SimulateLearner(const IReviewStrategy& strategy, const AnswerModel& model, const SessionLimits& limits,
+    uint learner, uint days, uint cards, std::vector<DayStats>& stats)
+{
+    std::mt19937 random(learner);
+    std::uniform_real_distribution<double> ease(0.8, 1.2);
+
+    std::vector<DeckRecord> deck = DeckBuilder(start)
+        .WithNewCards(cards / 2)
+        .WithDueCards(cards / 4, 50)
+        .WithFutureCards(cards - cards / 2 - cards / 4, DifficultyRatingEasiest)
+        .Build();
+
+    std::vector<CardMemory> memory(deck.size());
+
+    for (size_t i = 0; i < deck.size(); i++)
+    {
+        const bool seen = deck[i].state != CardState::NeverReviewed;
+        const double interval = seen ? static_cast<double>(deck[i].reviewDate - deck[i].previousCorrectReview) / day : 0.0;
+
+        memory[i] = CardMemory{ std::max(interval, model.initialStability), ease(random), seen ? deck[i].reviewDate : 0 };
+    }
+
+    StudySession session(strategy, limits.newCards, limits.existingCards, cards);
+    std::vector<ExportedRecord> exported(deck.size());
+
+    for (uint d = 0; d < days; d++)
+    {
+        // -- study in the morning, a few seconds per card...
+        Timestamp now = start + d * day + 9 * 60 * 60;
+
+        session.Reset();
+        session.ImportRecords(deck.data(), static_cast<uint>(deck.size()));
+
+        while (std::optional<uint> i = session.NextReview(now))
+        {
+            const ReviewOutcome outcome = Answer(model, memory[*i], now, random);
+
+            session.UpdateCard(*i, outcome, now);
+            now += 8;
+
+            stats[d].reviews++;
+            stats[d].correct += (outcome != ReviewOutcome::Incorrect) ? 1 : 0;
+            stats[d].calls += 2;
+        }
+
+        stats[d].calls++;
+
+        // -- carry the deck over to tomorrow, counting what came due today but wasn't reviewed...
+        session.ExportRecords(now, exported.data());
+
+        const Timestamp startOfDay = start + d * day;
+        const Timestamp endOfDay = startOfDay + day;
+
+        for (size_t i = 0; i < deck.size(); i++)
+        {
+            const bool reviewedToday = memory[i].lastReview >= startOfDay;
+
+            deck[i] = exported[i].card;
+            stats[d].backlog += (exported[i].nextReview < endOfDay && !reviewedToday) ? 1 : 0;
+        }
+    }
+}
+
+// -- every learner with the same seed per learner, so both strategies see the same learners...
+std::vector<DayStats> Simulate(const IReviewStrategy& strategy, const AnswerModel& model, const SessionLimits& limits,
+    uint learners, uint days, uint cards, double& callsPerSecond)
+{
+    const uint threads = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<std::vector<DayStats>> perThread(threads, std::vector<DayStats>(days));
+    std::atomic<uint> nextLearner{ 0 };
+    std::vector<std::thread> pool;
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (uint t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&, t]()
+        {
+            for (uint learner = nextLearner++; learner < learners; learner = nextLearner++)
+            {
+                SimulateLearner(strategy, model, limits, learner, days, cards, perThread[t]);
+            }
+        });
+    }
+
+    for (std::thread& worker : pool)
+    {
+        worker.join();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::vector<DayStats> total(days);
+    uint64_t calls = 0;
+
+    for (const std::vector<DayStats>& stats : perThread)
+    {
+        for (uint d = 0; d < days; d++)
+        {
+            total[d].reviews += stats[d].reviews;
+            total[d].correct += stats[d].correct;
+            total[d].backlog += stats[d].backlog;
+            total[d].calls += stats[d].calls;
+            calls += stats[d].calls;
+        }
+    }
+
+    callsPerSecond = calls / elapsed.count();
+
+    return total;
+}
+
+void Report(const char* name, const std::vector<DayStats>& stats, uint learners, double callsPerSecond)
+{
+    std::printf("\n%s\n%6s %16s %12s %16s\n", name, "day", "reviews/learner", "recall", "backlog/learner");
+
+    for (size_t d = 0; d < stats.size(); d++)
+    {
+        if (d < 7 || (d + 1) % 10 == 0)
+        {
+            const double recall = stats[d].reviews ? static_cast<double>(stats[d].correct) / stats[d].reviews : 0.0;
+
+            std::printf("%6zu %16.1f %12.3f %16.1f\n", d + 1,
+                static_cast<double>(stats[d].reviews) / learners, recall, static_cast<double>(stats[d].backlog) / learners);
+        }
+    }
+
+    std::printf("%.0f NextReview + UpdateCard calls per second on %u threads\n", callsPerSecond, std::max(std::thread::hardware_concurrency(), 1U));
+}
+
+int main(int argc, char* argv[])
+{
+    const uint learners = (argc > 1) ? static_cast<uint>(std::atoi(argv[1])) : 1000;
+    const uint days = (argc > 2) ? static_cast<uint>(std::atoi(argv[2])) : 60;
+    const uint cards = (argc > 3) ? static_cast<uint>(std::atoi(argv[3])) : 500;
+
+    if (learners == 0 || days == 0 || cards == 0)
+    {
+        std::fprintf(stderr, "usage: Simulator [learners] [days] [cards]\n");
+        return 1;
+    }
+
+    const AnswerModel model;
+    const SessionLimits limits;
+    const SimpleReviewStrategy simple;
+    const SuperMemo2ReviewStrategy superMemo2;
+
+    std::printf("%u learners, %u days, %u cards each\n", learners, days, cards);
+
+    double callsPerSecond = 0;
+
+    const std::vector<DayStats> simpleStats = Simulate(simple, model, limits, learners, days, cards, callsPerSecond);
+    Report("SimpleReviewStrategy", simpleStats, learners, callsPerSecond);
+
+    const std::vector<DayStats> superMemo2Stats = Simulate(superMemo2, model, limits, learners, days, cards, callsPerSecond);
+    Report("SuperMemo2ReviewStrategy", superMemo2Stats, learners, callsPerSecond);
+
+    return 0;
+}